@@ -8,13 +8,20 @@
 */
 
 #include "BQ25672.h"
+#include "BQ25672Calibration.h"
+#include "BQ25672EventDispatcher.h"
+#include "BQ25672FlagStatistics.h"
+#include "BQ25672WatchdogKeepalive.h"
+#include "BQ25672ChargeProfile.h"
+
+#define BQ25672_BURST_CHUNK_SIZE 16  // Stay well within the 32 byte Wire buffer of small boards
 
 BQ25672::BQ25672():
-	timeout_time(50), _Serial(NULL) {
+	_Serial(NULL), _calibration(NULL), _dispatcher(NULL), _statistics(NULL), _keepalive(NULL), _bus_lock(NULL), _bus_lock_context(NULL), timeout_time(50) {
 }
 
 BQ25672::BQ25672(HardwareSerial *serial):
-	timeout_time(50) {
+	_calibration(NULL), _dispatcher(NULL), _statistics(NULL), _keepalive(NULL), _bus_lock(NULL), _bus_lock_context(NULL), timeout_time(50) {
 	_Serial = serial;
 }
 
@@ -100,7 +107,9 @@ bool BQ25672::read_bytes(uint8_t reg, uint16_t *data, uint8_t byte_cnt){
 
 uint16_t BQ25672::read_var(uint8_t reg, uint8_t byte_cnt, uint8_t bit_start, uint8_t bit_end){
 	uint16_t data;
+	lockBus(true);
 	bool success = read_bytes(reg, &data, byte_cnt);
+	lockBus(false);
 	if(!success) return 0;
 
 	uint16_t bit_mask = (0xFFFF >> (16 - (bit_end - bit_start + 1))) << bit_start;
@@ -114,14 +123,14 @@ bool BQ25672::write_bytes(uint8_t reg, uint16_t data, uint8_t byte_cnt){
 	_bus->beginTransmission(_i2caddr);
 	_bus->write(reg);
 
+	uint8_t _data[2];
 	if (byte_cnt == 1){
-		uint8_t _data = data & 0x00FF;
-		_bus->write(_data);
+		_data[0] = outgoing(reg, data & 0x00FF);
+		_bus->write(_data[0]);
 	}
     else if(byte_cnt == 2){
-		uint8_t _data[2];
-		_data[0] = (data & 0xFF00) >> 8;
-		_data[1] = data & 0x00FF;
+		_data[0] = outgoing(reg, (data & 0xFF00) >> 8);
+		_data[1] = outgoing(reg + 1, data & 0x00FF);
 		_bus->write(_data, 2);
 	}
 	else{
@@ -133,18 +142,96 @@ bool BQ25672::write_bytes(uint8_t reg, uint16_t data, uint8_t byte_cnt){
 	if(error){
 		return false;
 	}
+	if(_keepalive != NULL) _keepalive->notifyWrite(reg, _data, byte_cnt);
+	return true;
+}
+
+bool BQ25672::read_burst(uint8_t reg, uint8_t *data, uint8_t byte_cnt){
+	lockBus(true);
+	bool success = read_chunks(reg, data, byte_cnt);
+	lockBus(false);
+	return success;
+}
+
+bool BQ25672::write_burst(uint8_t reg, const uint8_t *data, uint8_t byte_cnt){
+	lockBus(true);
+	bool success = write_chunks(reg, data, byte_cnt);
+	lockBus(false);
+	return success;
+}
+
+bool BQ25672::read_chunks(uint8_t reg, uint8_t *data, uint8_t byte_cnt){
+	// Reads byte_cnt consecutive registers, the BQ25672 auto-increments the register address
+	for(int done = 0; done < byte_cnt; ){
+		uint8_t chunk = byte_cnt - done;
+		if(chunk > BQ25672_BURST_CHUNK_SIZE) chunk = BQ25672_BURST_CHUNK_SIZE;
+
+		_bus->beginTransmission(_i2caddr);
+		_bus->write((uint8_t)(reg + done));
+		int error = _bus->endTransmission();
+
+		if(error){
+			return false;
+		}
+
+		_bus->requestFrom(_i2caddr, chunk);
+		unsigned long timeout_timer = millis();
+		while (_bus->available() < chunk){
+			if(millis() - timeout_timer > timeout_time) return false;
+		}
+
+		for(int i = 0; i < chunk; i++){
+			data[done + i] = _bus->read();
+		}
+		done += chunk;
+	}
+	return true;
+}
+
+bool BQ25672::write_chunks(uint8_t reg, const uint8_t *data, uint8_t byte_cnt){
+	// Writes byte_cnt consecutive registers, the BQ25672 auto-increments the register address
+	for(int done = 0; done < byte_cnt; ){
+		uint8_t chunk = byte_cnt - done;
+		if(chunk > BQ25672_BURST_CHUNK_SIZE) chunk = BQ25672_BURST_CHUNK_SIZE;
+
+		_bus->beginTransmission(_i2caddr);
+		_bus->write((uint8_t)(reg + done));
+		for(int i = 0; i < chunk; i++){
+			_bus->write(outgoing(reg + done + i, data[done + i]));
+		}
+		int error = _bus->endTransmission();
+
+		if(error){
+			return false;
+		}
+		done += chunk;
+	}
+	if(_keepalive != NULL) _keepalive->notifyWrite(reg, data, byte_cnt);
 	return true;
 }
 
+void BQ25672::lockBus(bool lock){
+	if(_bus_lock != NULL) _bus_lock(lock, _bus_lock_context);
+}
+
+uint8_t BQ25672::outgoing(uint8_t reg, uint8_t data){
+	// With a keepalive attached, every write of REG10 also resets the watchdog
+	if(_keepalive != NULL && reg == BQ25672_WATCHDOG_REGISTER) return data | BQ25672_WATCHDOG_RESET_BIT;
+	return data;
+}
+
 bool BQ25672::write_var(uint8_t reg, uint8_t byte_cnt, uint8_t bit_start, uint8_t bit_end, uint16_t new_data){
 	if(!((1 << bit_end - bit_start + 1) > new_data && new_data >= 0)){
 		// Data is out of range
 		return false;
 	}
+	// The read and the write are one locked sequence, so no other task writes in between
 	uint16_t old_data;
+	lockBus(true);
 	bool success = read_bytes(reg, &old_data, byte_cnt);
 
 	if(!success){
+		lockBus(false);
 		return false;
 	}
 
@@ -159,12 +246,86 @@ bool BQ25672::write_var(uint8_t reg, uint8_t byte_cnt, uint8_t bit_start, uint8_
 	new_data = new_data | old_data_msb;
 
 	success = write_bytes(reg, new_data, byte_cnt);
+	lockBus(false);
 
 	// TODO: Finish function with read back check
 
 	return success;
 }
 
+int32_t BQ25672::calibrate(uint8_t channel, int32_t raw){
+	if(_calibration == NULL) return raw;
+	return _calibration->apply(channel, raw);
+}
+
+void BQ25672::setCalibration(BQ25672Calibration *calibration){
+	// Pass NULL to disable calibration
+	_calibration = calibration;
+}
+
+BQ25672Calibration *BQ25672::getCalibration(){
+	return _calibration;
+}
+
+bool BQ25672::readRegisters(uint8_t reg, uint8_t *data, uint8_t byte_cnt){
+	return read_burst(reg, data, byte_cnt);
+}
+
+bool BQ25672::writeRegisters(uint8_t reg, const uint8_t *data, uint8_t byte_cnt){
+	return write_burst(reg, data, byte_cnt);
+}
+
+void BQ25672::setBusLock(BQ25672BusLockFunction lock_function, void *context){
+	// Pass NULL when the charger is only used from one task
+	_bus_lock = lock_function;
+	_bus_lock_context = context;
+}
+
+void BQ25672::setWatchdogKeepalive(BQ25672WatchdogKeepalive *keepalive){
+	// Every write is reported to the keepalive, pass NULL to detach
+	_keepalive = keepalive;
+}
+
+bool BQ25672::applyProfile(BQ25672ChargeProfile *profile){
+	// Writes only the registers that differ, restores them if the read back fails
+	return profile->apply(this);
+}
+
+void BQ25672::setEventDispatcher(BQ25672EventDispatcher *dispatcher){
+	// readFlags() passes the flags to the dispatcher, pass NULL to detach
+	_dispatcher = dispatcher;
+}
+
+void BQ25672::setFlagStatistics(BQ25672FlagStatistics *statistics){
+	// readFlags() counts the flags in the statistics, pass NULL to detach
+	_statistics = statistics;
+}
+
+bool BQ25672::subscribe(BQ25672EventSet events){
+	// Only the events in the set pull the INT pin, all mask registers are written in one burst
+
+	uint8_t masks[6];
+	BQ25672EventSet masked = ~events & BQ25672_EVENTS_ALL;
+
+	for(int i = 0; i < 6; i++){
+		masks[i] = (masked >> (8 * i)) & 0xFF;
+	}
+	return write_burst(mask_registers[0], masks, 6);
+}
+
+BQ25672EventSet BQ25672::getSubscribedEvents(){
+	// Returns 0 if the mask registers could not be read
+
+	uint8_t masks[6];
+	if(!read_burst(mask_registers[0], masks, 6)) return 0;
+
+	BQ25672EventSet masked = 0;
+	for(int i = 0; i < 6; i++){
+		masked |= (BQ25672EventSet) masks[i] << (8 * i);
+	}
+	return ~masked & BQ25672_EVENTS_ALL;
+}
+
 
 
 int BQ25672::getMinSystemVoltage(){
@@ -873,6 +1034,36 @@ bool BQ25672::setHizModeEnabled(bool new_value){
 	return success;
 }
 
+bool BQ25672::getForceIcoStart(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0xf;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 3;
+	uint8_t bit_end = 3;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::ForceIcoStart(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES (cleared by the charger when ICO starts)
+
+	uint8_t reg = 0xf;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 3;
+	uint8_t bit_end = 3;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
 bool BQ25672::getIcoEnabled(){
 	// Return value:
 	// 0 = NO
@@ -1253,6 +1444,36 @@ bool BQ25672::setAutoDpdnDetectionEnabled(bool new_value){
 	return success;
 }
 
+bool BQ25672::getForceDpdnDetection(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x11;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 7;
+	uint8_t bit_end = 7;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::ForceDpdnDetection(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES (cleared by the charger when detection is done)
+
+	uint8_t reg = 0x11;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 7;
+	uint8_t bit_end = 7;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
 bool BQ25672::getOoaInForwardModeDisabled(){
 	// Return value:
 	// 0 = NO
@@ -3153,29 +3374,29 @@ uint8_t BQ25672::getFaultFlag(){
 	return flag_readout[5];
 }
 
-bool BQ25672::getStartAverageWithNewAdcConversion(){
+bool BQ25672::getBusVoltagePresentInterruptMasked(){
 	// Return value:
 	// 0 = NO
 	// 1 = YES
 
-	uint8_t reg = 0x2e;
+	uint8_t reg = 0x28;
 	uint8_t byte_cnt = 1;
-	uint8_t bit_start = 2;
-	uint8_t bit_end = 2;
+	uint8_t bit_start = 0;
+	uint8_t bit_end = 0;
 
 	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
 	return val;
 }
 
-bool BQ25672::setStartAverageWithNewAdcConversion(bool new_value){
+bool BQ25672::setBusVoltagePresentInterruptMasked(bool new_value){
 	// Set value:
 	// 0 = NO
 	// 1 = YES
 
-	uint8_t reg = 0x2e;
+	uint8_t reg = 0x28;
 	uint8_t byte_cnt = 1;
-	uint8_t bit_start = 2;
-	uint8_t bit_end = 2;
+	uint8_t bit_start = 0;
+	uint8_t bit_end = 0;
 
 	uint16_t new_data = (uint16_t) new_value;
 
@@ -3183,29 +3404,29 @@ bool BQ25672::setStartAverageWithNewAdcConversion(bool new_value){
 	return success;
 }
 
-bool BQ25672::getRunningAverageEnabled(){
+bool BQ25672::getInput1PresentInterruptMasked(){
 	// Return value:
 	// 0 = NO
 	// 1 = YES
 
-	uint8_t reg = 0x2e;
+	uint8_t reg = 0x28;
 	uint8_t byte_cnt = 1;
-	uint8_t bit_start = 3;
-	uint8_t bit_end = 3;
+	uint8_t bit_start = 1;
+	uint8_t bit_end = 1;
 
 	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
 	return val;
 }
 
-bool BQ25672::setRunningAverageEnabled(bool new_value){
+bool BQ25672::setInput1PresentInterruptMasked(bool new_value){
 	// Set value:
 	// 0 = NO
 	// 1 = YES
 
-	uint8_t reg = 0x2e;
+	uint8_t reg = 0x28;
 	uint8_t byte_cnt = 1;
-	uint8_t bit_start = 3;
-	uint8_t bit_end = 3;
+	uint8_t bit_start = 1;
+	uint8_t bit_end = 1;
 
 	uint16_t new_data = (uint16_t) new_value;
 
@@ -3213,33 +3434,29 @@ bool BQ25672::setRunningAverageEnabled(bool new_value){
 	return success;
 }
 
-int BQ25672::getAdcResolution(){
+bool BQ25672::getInput2PresentInterruptMasked(){
 	// Return value:
-	// 0 = 15
-	// 1 = 14
-	// 2 = 13
-	// 3 = 12
+	// 0 = NO
+	// 1 = YES
 
-	uint8_t reg = 0x2e;
+	uint8_t reg = 0x28;
 	uint8_t byte_cnt = 1;
-	uint8_t bit_start = 4;
-	uint8_t bit_end = 5;
+	uint8_t bit_start = 2;
+	uint8_t bit_end = 2;
 
 	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
 	return val;
 }
 
-bool BQ25672::setAdcResolution(int new_value){
+bool BQ25672::setInput2PresentInterruptMasked(bool new_value){
 	// Set value:
-	// 0 = 15
-	// 1 = 14
-	// 2 = 13
-	// 3 = 12
+	// 0 = NO
+	// 1 = YES
 
-	uint8_t reg = 0x2e;
+	uint8_t reg = 0x28;
 	uint8_t byte_cnt = 1;
-	uint8_t bit_start = 4;
-	uint8_t bit_end = 5;
+	uint8_t bit_start = 2;
+	uint8_t bit_end = 2;
 
 	uint16_t new_data = (uint16_t) new_value;
 
@@ -3247,29 +3464,29 @@ bool BQ25672::setAdcResolution(int new_value){
 	return success;
 }
 
-int BQ25672::getAdcConversion(){
+bool BQ25672::getPowerGoodInterruptMasked(){
 	// Return value:
-	// 0 = Continuous
-	// 1 = One shot
+	// 0 = NO
+	// 1 = YES
 
-	uint8_t reg = 0x2e;
+	uint8_t reg = 0x28;
 	uint8_t byte_cnt = 1;
-	uint8_t bit_start = 6;
-	uint8_t bit_end = 6;
+	uint8_t bit_start = 3;
+	uint8_t bit_end = 3;
 
 	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
 	return val;
 }
 
-bool BQ25672::setAdcConversion(int new_value){
+bool BQ25672::setPowerGoodInterruptMasked(bool new_value){
 	// Set value:
-	// 0 = Continuous
-	// 1 = One shot
+	// 0 = NO
+	// 1 = YES
 
-	uint8_t reg = 0x2e;
+	uint8_t reg = 0x28;
 	uint8_t byte_cnt = 1;
-	uint8_t bit_start = 6;
-	uint8_t bit_end = 6;
+	uint8_t bit_start = 3;
+	uint8_t bit_end = 3;
 
 	uint16_t new_data = (uint16_t) new_value;
 
@@ -3277,29 +3494,29 @@ bool BQ25672::setAdcConversion(int new_value){
 	return success;
 }
 
-bool BQ25672::getAdcEnabled(){
+bool BQ25672::getPoorSourceInterruptMasked(){
 	// Return value:
 	// 0 = NO
 	// 1 = YES
 
-	uint8_t reg = 0x2e;
+	uint8_t reg = 0x28;
 	uint8_t byte_cnt = 1;
-	uint8_t bit_start = 7;
-	uint8_t bit_end = 7;
+	uint8_t bit_start = 4;
+	uint8_t bit_end = 4;
 
 	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
 	return val;
 }
 
-bool BQ25672::setAdcEnabled(bool new_value){
+bool BQ25672::setPoorSourceInterruptMasked(bool new_value){
 	// Set value:
 	// 0 = NO
 	// 1 = YES
 
-	uint8_t reg = 0x2e;
+	uint8_t reg = 0x28;
 	uint8_t byte_cnt = 1;
-	uint8_t bit_start = 7;
-	uint8_t bit_end = 7;
+	uint8_t bit_start = 4;
+	uint8_t bit_end = 4;
 
 	uint16_t new_data = (uint16_t) new_value;
 
@@ -3307,29 +3524,29 @@ bool BQ25672::setAdcEnabled(bool new_value){
 	return success;
 }
 
-bool BQ25672::getDieTemperatureAdcControlDisabled(){
+bool BQ25672::getWatchdogTimerInterruptMasked(){
 	// Return value:
 	// 0 = NO
 	// 1 = YES
 
-	uint8_t reg = 0x2f;
+	uint8_t reg = 0x28;
 	uint8_t byte_cnt = 1;
-	uint8_t bit_start = 1;
-	uint8_t bit_end = 1;
+	uint8_t bit_start = 5;
+	uint8_t bit_end = 5;
 
 	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
 	return val;
 }
 
-bool BQ25672::setDieTemperatureAdcControlDisabled(bool new_value){
+bool BQ25672::setWatchdogTimerInterruptMasked(bool new_value){
 	// Set value:
 	// 0 = NO
 	// 1 = YES
 
-	uint8_t reg = 0x2f;
+	uint8_t reg = 0x28;
 	uint8_t byte_cnt = 1;
-	uint8_t bit_start = 1;
-	uint8_t bit_end = 1;
+	uint8_t bit_start = 5;
+	uint8_t bit_end = 5;
 
 	uint16_t new_data = (uint16_t) new_value;
 
@@ -3337,29 +3554,29 @@ bool BQ25672::setDieTemperatureAdcControlDisabled(bool new_value){
 	return success;
 }
 
-bool BQ25672::getNtcAdcControlDisabled(){
+bool BQ25672::getVindpmRegulationInterruptMasked(){
 	// Return value:
 	// 0 = NO
 	// 1 = YES
 
-	uint8_t reg = 0x2f;
+	uint8_t reg = 0x28;
 	uint8_t byte_cnt = 1;
-	uint8_t bit_start = 2;
-	uint8_t bit_end = 2;
+	uint8_t bit_start = 6;
+	uint8_t bit_end = 6;
 
 	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
 	return val;
 }
 
-bool BQ25672::setNtcAdcControlDisabled(bool new_value){
+bool BQ25672::setVindpmRegulationInterruptMasked(bool new_value){
 	// Set value:
 	// 0 = NO
 	// 1 = YES
 
-	uint8_t reg = 0x2f;
+	uint8_t reg = 0x28;
 	uint8_t byte_cnt = 1;
-	uint8_t bit_start = 2;
-	uint8_t bit_end = 2;
+	uint8_t bit_start = 6;
+	uint8_t bit_end = 6;
 
 	uint16_t new_data = (uint16_t) new_value;
 
@@ -3367,29 +3584,29 @@ bool BQ25672::setNtcAdcControlDisabled(bool new_value){
 	return success;
 }
 
-bool BQ25672::getSystemVoltageAdcControlDisabled(){
+bool BQ25672::getIindpmRegulationInterruptMasked(){
 	// Return value:
 	// 0 = NO
 	// 1 = YES
 
-	uint8_t reg = 0x2f;
+	uint8_t reg = 0x28;
 	uint8_t byte_cnt = 1;
-	uint8_t bit_start = 3;
-	uint8_t bit_end = 3;
+	uint8_t bit_start = 7;
+	uint8_t bit_end = 7;
 
 	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
 	return val;
 }
 
-bool BQ25672::setSystemVoltageAdcControlDisabled(bool new_value){
+bool BQ25672::setIindpmRegulationInterruptMasked(bool new_value){
 	// Set value:
 	// 0 = NO
 	// 1 = YES
 
-	uint8_t reg = 0x2f;
+	uint8_t reg = 0x28;
 	uint8_t byte_cnt = 1;
-	uint8_t bit_start = 3;
-	uint8_t bit_end = 3;
+	uint8_t bit_start = 7;
+	uint8_t bit_end = 7;
 
 	uint16_t new_data = (uint16_t) new_value;
 
@@ -3397,29 +3614,29 @@ bool BQ25672::setSystemVoltageAdcControlDisabled(bool new_value){
 	return success;
 }
 
-bool BQ25672::getBatteryVoltageAdcControlDisabled(){
+bool BQ25672::getUsbBc12DoneInterruptMasked(){
 	// Return value:
 	// 0 = NO
 	// 1 = YES
 
-	uint8_t reg = 0x2f;
+	uint8_t reg = 0x29;
 	uint8_t byte_cnt = 1;
-	uint8_t bit_start = 4;
-	uint8_t bit_end = 4;
+	uint8_t bit_start = 0;
+	uint8_t bit_end = 0;
 
 	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
 	return val;
 }
 
-bool BQ25672::setBatteryVoltageAdcControlDisabled(bool new_value){
+bool BQ25672::setUsbBc12DoneInterruptMasked(bool new_value){
 	// Set value:
 	// 0 = NO
 	// 1 = YES
 
-	uint8_t reg = 0x2f;
+	uint8_t reg = 0x29;
 	uint8_t byte_cnt = 1;
-	uint8_t bit_start = 4;
-	uint8_t bit_end = 4;
+	uint8_t bit_start = 0;
+	uint8_t bit_end = 0;
 
 	uint16_t new_data = (uint16_t) new_value;
 
@@ -3427,29 +3644,1203 @@ bool BQ25672::setBatteryVoltageAdcControlDisabled(bool new_value){
 	return success;
 }
 
-bool BQ25672::getBusVoltageAdcControlDisabled(){
+bool BQ25672::getBatteryPresentInterruptMasked(){
 	// Return value:
 	// 0 = NO
 	// 1 = YES
 
-	uint8_t reg = 0x2f;
+	uint8_t reg = 0x29;
 	uint8_t byte_cnt = 1;
-	uint8_t bit_start = 5;
-	uint8_t bit_end = 5;
+	uint8_t bit_start = 1;
+	uint8_t bit_end = 1;
 
 	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
 	return val;
 }
 
-bool BQ25672::setBusVoltageAdcControlDisabled(bool new_value){
+bool BQ25672::setBatteryPresentInterruptMasked(bool new_value){
 	// Set value:
 	// 0 = NO
 	// 1 = YES
 
-	uint8_t reg = 0x2f;
+	uint8_t reg = 0x29;
 	uint8_t byte_cnt = 1;
-	uint8_t bit_start = 5;
-	uint8_t bit_end = 5;
+	uint8_t bit_start = 1;
+	uint8_t bit_end = 1;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getThermalRegulationInterruptMasked(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x29;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 2;
+	uint8_t bit_end = 2;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setThermalRegulationInterruptMasked(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x29;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 2;
+	uint8_t bit_end = 2;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getBusVoltageStatusInterruptMasked(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x29;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 4;
+	uint8_t bit_end = 4;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setBusVoltageStatusInterruptMasked(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x29;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 4;
+	uint8_t bit_end = 4;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getIcoStatusInterruptMasked(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x29;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 6;
+	uint8_t bit_end = 6;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setIcoStatusInterruptMasked(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x29;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 6;
+	uint8_t bit_end = 6;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getChargeStatusInterruptMasked(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x29;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 7;
+	uint8_t bit_end = 7;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setChargeStatusInterruptMasked(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x29;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 7;
+	uint8_t bit_end = 7;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getTopOffTimerInterruptMasked(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2a;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 0;
+	uint8_t bit_end = 0;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setTopOffTimerInterruptMasked(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2a;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 0;
+	uint8_t bit_end = 0;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getPreChargeTimerInterruptMasked(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2a;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 1;
+	uint8_t bit_end = 1;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setPreChargeTimerInterruptMasked(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2a;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 1;
+	uint8_t bit_end = 1;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getTrickleChargeTimerInterruptMasked(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2a;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 2;
+	uint8_t bit_end = 2;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setTrickleChargeTimerInterruptMasked(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2a;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 2;
+	uint8_t bit_end = 2;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getFastChargeTimerInterruptMasked(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2a;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 3;
+	uint8_t bit_end = 3;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setFastChargeTimerInterruptMasked(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2a;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 3;
+	uint8_t bit_end = 3;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getMinSystemVoltageRegulationInterruptMasked(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2a;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 4;
+	uint8_t bit_end = 4;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setMinSystemVoltageRegulationInterruptMasked(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2a;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 4;
+	uint8_t bit_end = 4;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getAdcConversionDoneInterruptMasked(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2a;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 5;
+	uint8_t bit_end = 5;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setAdcConversionDoneInterruptMasked(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2a;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 5;
+	uint8_t bit_end = 5;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getDpdnDetectionDoneInterruptMasked(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2a;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 6;
+	uint8_t bit_end = 6;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setDpdnDetectionDoneInterruptMasked(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2a;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 6;
+	uint8_t bit_end = 6;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getBatteryHotInterruptMasked(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2b;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 0;
+	uint8_t bit_end = 0;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setBatteryHotInterruptMasked(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2b;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 0;
+	uint8_t bit_end = 0;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getBatteryWarmInterruptMasked(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2b;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 1;
+	uint8_t bit_end = 1;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setBatteryWarmInterruptMasked(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2b;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 1;
+	uint8_t bit_end = 1;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getBatteryCoolInterruptMasked(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2b;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 2;
+	uint8_t bit_end = 2;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setBatteryCoolInterruptMasked(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2b;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 2;
+	uint8_t bit_end = 2;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getBatteryColdInterruptMasked(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2b;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 3;
+	uint8_t bit_end = 3;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setBatteryColdInterruptMasked(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2b;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 3;
+	uint8_t bit_end = 3;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getBatteryUvloForOtgInterruptMasked(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2b;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 4;
+	uint8_t bit_end = 4;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setBatteryUvloForOtgInterruptMasked(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2b;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 4;
+	uint8_t bit_end = 4;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getInput1OvpInterruptMasked(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2c;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 0;
+	uint8_t bit_end = 0;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setInput1OvpInterruptMasked(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2c;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 0;
+	uint8_t bit_end = 0;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getInput2OvpInterruptMasked(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2c;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 1;
+	uint8_t bit_end = 1;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setInput2OvpInterruptMasked(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2c;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 1;
+	uint8_t bit_end = 1;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getConverterOcpInterruptMasked(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2c;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 2;
+	uint8_t bit_end = 2;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setConverterOcpInterruptMasked(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2c;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 2;
+	uint8_t bit_end = 2;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getBatteryCurrentOcpInterruptMasked(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2c;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 3;
+	uint8_t bit_end = 3;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setBatteryCurrentOcpInterruptMasked(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2c;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 3;
+	uint8_t bit_end = 3;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getBusCurrentOcpInterruptMasked(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2c;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 4;
+	uint8_t bit_end = 4;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setBusCurrentOcpInterruptMasked(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2c;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 4;
+	uint8_t bit_end = 4;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getBatteryVoltageOvpInterruptMasked(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2c;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 5;
+	uint8_t bit_end = 5;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setBatteryVoltageOvpInterruptMasked(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2c;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 5;
+	uint8_t bit_end = 5;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getBusVoltageOvpInterruptMasked(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2c;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 6;
+	uint8_t bit_end = 6;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setBusVoltageOvpInterruptMasked(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2c;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 6;
+	uint8_t bit_end = 6;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getBatteryDischargeCurrentRegulationInterruptMasked(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2c;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 7;
+	uint8_t bit_end = 7;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setBatteryDischargeCurrentRegulationInterruptMasked(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2c;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 7;
+	uint8_t bit_end = 7;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getThermalShutdownInterruptMasked(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2d;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 2;
+	uint8_t bit_end = 2;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setThermalShutdownInterruptMasked(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2d;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 2;
+	uint8_t bit_end = 2;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getOtgUnderVoltageInterruptMasked(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2d;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 4;
+	uint8_t bit_end = 4;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setOtgUnderVoltageInterruptMasked(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2d;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 4;
+	uint8_t bit_end = 4;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getOtgOverVoltageInterruptMasked(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2d;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 5;
+	uint8_t bit_end = 5;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setOtgOverVoltageInterruptMasked(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2d;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 5;
+	uint8_t bit_end = 5;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getSystemOverVoltageInterruptMasked(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2d;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 6;
+	uint8_t bit_end = 6;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setSystemOverVoltageInterruptMasked(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2d;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 6;
+	uint8_t bit_end = 6;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getSystemShortCircuitInterruptMasked(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2d;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 7;
+	uint8_t bit_end = 7;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setSystemShortCircuitInterruptMasked(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2d;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 7;
+	uint8_t bit_end = 7;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getStartAverageWithNewAdcConversion(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2e;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 2;
+	uint8_t bit_end = 2;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setStartAverageWithNewAdcConversion(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2e;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 2;
+	uint8_t bit_end = 2;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getRunningAverageEnabled(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2e;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 3;
+	uint8_t bit_end = 3;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setRunningAverageEnabled(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2e;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 3;
+	uint8_t bit_end = 3;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+int BQ25672::getAdcResolution(){
+	// Return value:
+	// 0 = 15
+	// 1 = 14
+	// 2 = 13
+	// 3 = 12
+
+	uint8_t reg = 0x2e;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 4;
+	uint8_t bit_end = 5;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setAdcResolution(int new_value){
+	// Set value:
+	// 0 = 15
+	// 1 = 14
+	// 2 = 13
+	// 3 = 12
+
+	uint8_t reg = 0x2e;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 4;
+	uint8_t bit_end = 5;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+int BQ25672::getAdcConversion(){
+	// Return value:
+	// 0 = Continuous
+	// 1 = One shot
+
+	uint8_t reg = 0x2e;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 6;
+	uint8_t bit_end = 6;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setAdcConversion(int new_value){
+	// Set value:
+	// 0 = Continuous
+	// 1 = One shot
+
+	uint8_t reg = 0x2e;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 6;
+	uint8_t bit_end = 6;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getAdcEnabled(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2e;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 7;
+	uint8_t bit_end = 7;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setAdcEnabled(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2e;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 7;
+	uint8_t bit_end = 7;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getDieTemperatureAdcControlDisabled(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2f;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 1;
+	uint8_t bit_end = 1;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setDieTemperatureAdcControlDisabled(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2f;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 1;
+	uint8_t bit_end = 1;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getNtcAdcControlDisabled(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2f;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 2;
+	uint8_t bit_end = 2;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setNtcAdcControlDisabled(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2f;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 2;
+	uint8_t bit_end = 2;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getSystemVoltageAdcControlDisabled(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2f;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 3;
+	uint8_t bit_end = 3;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setSystemVoltageAdcControlDisabled(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2f;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 3;
+	uint8_t bit_end = 3;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getBatteryVoltageAdcControlDisabled(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2f;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 4;
+	uint8_t bit_end = 4;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setBatteryVoltageAdcControlDisabled(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2f;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 4;
+	uint8_t bit_end = 4;
+
+	uint16_t new_data = (uint16_t) new_value;
+
+	bool success  = write_var(reg, byte_cnt, bit_start, bit_end, new_data);
+	return success;
+}
+
+bool BQ25672::getBusVoltageAdcControlDisabled(){
+	// Return value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2f;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 5;
+	uint8_t bit_end = 5;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return val;
+}
+
+bool BQ25672::setBusVoltageAdcControlDisabled(bool new_value){
+	// Set value:
+	// 0 = NO
+	// 1 = YES
+
+	uint8_t reg = 0x2f;
+	uint8_t byte_cnt = 1;
+	uint8_t bit_start = 5;
+	uint8_t bit_end = 5;
 
 	uint16_t new_data = (uint16_t) new_value;
 
@@ -3648,7 +5039,7 @@ int BQ25672::getInputCurrent(){
 	uint8_t lsb = 1;
 
 	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
-	return ((int16_t) val) * lsb + offset;  // First convert to int16_t as it is a 2'complement number
+	return calibrate(BQ25672_ADC_IBUS, (int16_t) val) * lsb + offset;  // First convert to int16_t as it is a 2'complement number
 }
 
 int BQ25672::getBatteryCurrent(){
@@ -3662,7 +5053,7 @@ int BQ25672::getBatteryCurrent(){
 	uint8_t lsb = 1;
 
 	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
-	return ((int16_t) val) * lsb + offset;  // First convert to int16_t as it is a 2'complement number
+	return calibrate(BQ25672_ADC_IBAT, (int16_t) val) * lsb + offset;  // First convert to int16_t as it is a 2'complement number
 }
 
 int BQ25672::getBusVoltage(){
@@ -3676,7 +5067,7 @@ int BQ25672::getBusVoltage(){
 	uint8_t lsb = 1;
 
 	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
-	return val * lsb + offset;
+	return calibrate(BQ25672_ADC_VBUS, val) * lsb + offset;
 }
 
 int BQ25672::getInput1Voltage(){
@@ -3690,7 +5081,7 @@ int BQ25672::getInput1Voltage(){
 	uint8_t lsb = 1;
 
 	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
-	return val * lsb + offset;
+	return calibrate(BQ25672_ADC_VAC1, val) * lsb + offset;
 }
 
 int BQ25672::getInput2Voltage(){
@@ -3704,7 +5095,7 @@ int BQ25672::getInput2Voltage(){
 	uint8_t lsb = 1;
 
 	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
-	return val * lsb + offset;
+	return calibrate(BQ25672_ADC_VAC2, val) * lsb + offset;
 }
 
 int BQ25672::getBatteryVoltage(){
@@ -3718,7 +5109,7 @@ int BQ25672::getBatteryVoltage(){
 	uint8_t lsb = 1;
 
 	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
-	return val * lsb + offset;
+	return calibrate(BQ25672_ADC_VBAT, val) * lsb + offset;
 }
 
 int BQ25672::getSystemVoltage(){
@@ -3732,7 +5123,7 @@ int BQ25672::getSystemVoltage(){
 	uint8_t lsb = 1;
 
 	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
-	return val * lsb + offset;
+	return calibrate(BQ25672_ADC_VSYS, val) * lsb + offset;
 }
 
 float BQ25672::getNtcReading(){
@@ -3746,7 +5137,19 @@ float BQ25672::getNtcReading(){
 	float lsb = 0.0976563;
 
 	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
-	return val * lsb + offset;
+	return calibrate(BQ25672_ADC_TS, val) * lsb + offset;
+}
+
+int BQ25672::getNtcReadingCode(){
+	// Returns value in: LSB (0.0976563 %), calibrated ADC code
+
+	uint8_t reg = 0x3f;
+	uint8_t byte_cnt = 2;
+	uint8_t bit_start = 0;
+	uint8_t bit_end = 15;
+
+	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
+	return calibrate(BQ25672_ADC_TS, val);
 }
 
 float BQ25672::getDieTemperature(){
@@ -3760,7 +5163,7 @@ float BQ25672::getDieTemperature(){
 	float lsb = 0.5;
 
 	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
-	return ((int16_t) val) * lsb + offset;  // First convert to int16_t as it is a 2'complement number
+	return calibrate(BQ25672_ADC_TDIE, (int16_t) val) * lsb + offset;  // First convert to int16_t as it is a 2'complement number
 }
 
 int BQ25672::getDpVoltage(){
@@ -3774,7 +5177,7 @@ int BQ25672::getDpVoltage(){
 	uint8_t lsb = 1;
 
 	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
-	return val * lsb + offset;
+	return calibrate(BQ25672_ADC_DP, val) * lsb + offset;
 }
 
 int BQ25672::getDnVoltage(){
@@ -3788,7 +5191,7 @@ int BQ25672::getDnVoltage(){
 	uint8_t lsb = 1;
 
 	uint16_t val  = read_var(reg, byte_cnt, bit_start, bit_end);
-	return val * lsb + offset;
+	return calibrate(BQ25672_ADC_DN, val) * lsb + offset;
 }
 
 int BQ25672::getDnOutput(){
@@ -3903,166 +5306,166 @@ int BQ25672::getDevicePartNr(){
 	return val * lsb + offset;
 }
 
+static const char *const event_names[BQ25672_EVENT_COUNT] = {
+	"Bus voltage present changed",
+	"Input 1 present changed",
+	"Input 2 present changed",
+	"Power good changed",
+	"Poor source detected",
+	"Watchdog timer passed",
+	"VINDPM-VOTG regulation signal detected",
+	"IINDPM-IOTG signal detected",
+	"BC12 detection status changed",
+	"Battery present status changed",
+	"Thermal regulation status changed",
+	"Reserved",
+	"Bus voltage status changed",
+	"Reserved",
+	"ICO status changed",
+	"Charge status changed",
+	"Top off timer expired",
+	"Pre-charge timer expired",
+	"Trickle charger timer expired",
+	"Fast charge timer expired",
+	"Entered or existed VSYSMIN regulation",
+	"ADC Conversion completed",
+	"D+/D- detection is completed",
+	"Reserved",
+	"TS across hot temperature (T5) is detected",
+	"TS across warm temperature (T3) is detected",
+	"TS across cool temperature (T2) is detected",
+	"TS across cold temperature (T1) is detected",
+	"VBAT falls below the threshold to enable the OTG mode",
+	"Reserved",
+	"Reserved",
+	"Reserved",
+	"Enter VAC1 OVP",
+	"Enter VAC2 OVP",
+	"Enter converter OCP",
+	"Enter discharged OCP",
+	"Enter IBUS OCP",
+	"Enter VBAT OVP",
+	"Enter VBUS OVP",
+	"Enter or exit IBAT regulation",
+	"Reserved",
+	"Reserved",
+	"TS shutdown signal rising threshold detected",
+	"Reserved",
+	"Stop OTG due to VBUS under-voltage",
+	"Stop OTG due to VBUS over voltage",
+	"Stop switching due to system over-voltage",
+	"Stop switching due to system short"
+};
+
+const char *BQ25672::getEventName(uint8_t event){
+	if(event >= BQ25672_EVENT_COUNT) return "";
+	return event_names[event];
+}
+
 bool BQ25672::readFlags(){
-	bool success = true;
+	// All flag registers are read in one burst, reading clears them
+	uint8_t flags[6];
+	bool success = read_burst(flag_registers[0], flags, 6);
+
+	if(!success){
+		return false;
+	}
 
-	for(int i = 0; i < sizeof(flag_readout)/sizeof(flag_readout[0]); i++){
-		success &= read_bytes(flag_registers[i], &flag_readout[i], 1);
+	flag_set = 0;
+	for(int i = 0; i < 6; i++){
+		flag_readout[i] = flags[i];
+		flag_set |= (BQ25672EventSet) flags[i] << (8 * i);
 	}
 
 	if(_Serial != NULL){
-		if(flag_readout[0] & (1 << 0)){
-			_Serial->println("BQ25672: Bus voltage present changed");
-		}
-		if(flag_readout[0] & (1 << 1)){
-			_Serial->println("BQ25672: Input 1 present changed");
-		}
-		if(flag_readout[0] & (1 << 2)){
-			_Serial->println("BQ25672: Input 2 present changed");
-		}
-		if(flag_readout[0] & (1 << 3)){
-			_Serial->println("BQ25672: Power good changed");
-		}
-		if(flag_readout[0] & (1 << 4)){
-			_Serial->println("BQ25672: Poor source detected");
-		}
-		if(flag_readout[0] & (1 << 5)){
-			_Serial->println("BQ25672: Watchdog timer passed");
-		}
-		if(flag_readout[0] & (1 << 6)){
-			_Serial->println("BQ25672: VINDPM-VOTG regulation signal detected");
-		}
-		if(flag_readout[0] & (1 << 7)){
-			_Serial->println("BQ25672: IINDPM-IOTG signal detected");
+		BQ25672EventSet pending = flag_set;
+		while(pending){
+			uint8_t event = __builtin_ctzll(pending);
+			pending &= pending - 1;
+			_Serial->print("BQ25672: ");
+			_Serial->println(event_names[event]);
 		}
+	}
 
-		if(flag_readout[1] & (1 << 0)){
-			_Serial->println("BQ25672: BC12 detection status changed");
-		}
-		if(flag_readout[1] & (1 << 1)){
-			_Serial->println("BQ25672: Battery present status changed");
-		}
-		if(flag_readout[1] & (1 << 2)){
-			_Serial->println("BQ25672: Thermal regulation status changed");
-		}
-		if(flag_readout[1] & (1 << 3)){
-			_Serial->println("BQ25672: Reserved");
-		}
-		if(flag_readout[1] & (1 << 4)){
-			_Serial->println("BQ25672: Bus voltage status changed");
-		}
-		if(flag_readout[1] & (1 << 5)){
-			_Serial->println("BQ25672: Reserved");
-		}
-		if(flag_readout[1] & (1 << 6)){
-			_Serial->println("BQ25672: ICO status changed");
-		}
-		if(flag_readout[1] & (1 << 7)){
-			_Serial->println("BQ25672: Charge status changed");
-		}
+	if(_statistics != NULL){
+		_statistics->record(flag_set, millis());
+	}
 
-		if(flag_readout[2] & (1 << 0)){
-			_Serial->println("BQ25672: Top off timer expired");
-		}
-		if(flag_readout[2] & (1 << 1)){
-			_Serial->println("BQ25672: Pre-charge timer expired");
-		}
-		if(flag_readout[2] & (1 << 2)){
-			_Serial->println("BQ25672: Trickle charger timer expired");
-		}
-		if(flag_readout[2] & (1 << 3)){
-			_Serial->println("BQ25672: Fast charge timer expired");
-		}
-		if(flag_readout[2] & (1 << 4)){
-			_Serial->println("BQ25672: Entered or existed VSYSMIN regulation");
-		}
-		if(flag_readout[2] & (1 << 5)){
-			_Serial->println("BQ25672: ADC Conversion completed");
-		}
-		if(flag_readout[2] & (1 << 6)){
-			_Serial->println("BQ25672: D+/D- detection is completed");
-		}
-		if(flag_readout[2] & (1 << 7)){
-			_Serial->println("BQ25672: Reserved");
-		}
+	if(_dispatcher != NULL){
+		_dispatcher->dispatch(flag_set);
+	}
+	return success;
+}
 
-		if(flag_readout[3] & (1 << 0)){
-			_Serial->println("BQ25672: TS across hot temperature (T5) is detected");
-		}
-		if(flag_readout[3] & (1 << 1)){
-			_Serial->println("BQ25672: TS across warm temperature (T3) is detected");
-		}
-		if(flag_readout[3] & (1 << 2)){
-			_Serial->println("BQ25672: TS across cool temperature (T2) is detected");
-		}
-		if(flag_readout[3] & (1 << 3)){
-			_Serial->println("BQ25672: TS across cold temperature (T1) is detected");
-		}
-		if(flag_readout[3] & (1 << 4)){
-			_Serial->println("BQ25672: VBAT falls below the threshold to enable the OTG mode");
-		}
-		if(flag_readout[3] & (1 << 5)){
-			_Serial->println("BQ25672: Reserved");
-		}
-		if(flag_readout[3] & (1 << 6)){
-			_Serial->println("BQ25672: Reserved");
-		}
-		if(flag_readout[3] & (1 << 7)){
-			_Serial->println("BQ25672: Reserved");
-		}
+BQ25672EventSet BQ25672::getFlags(){
+	// Returns the flags of the last readFlags() call
+	return flag_set;
+}
 
-		if(flag_readout[4] & (1 << 0)){
-			_Serial->println("BQ25672: Enter VAC1 OVP");
-		}
-		if(flag_readout[4] & (1 << 1)){
-			_Serial->println("BQ25672: Enter VAC2 OVP");
-		}
-		if(flag_readout[4] & (1 << 2)){
-			_Serial->println("BQ25672: Enter converter OCP");
-		}
-		if(flag_readout[4] & (1 << 3)){
-			_Serial->println("BQ25672: Enter discharged OCP");
-		}
-		if(flag_readout[4] & (1 << 4)){
-			_Serial->println("BQ25672: Enter IBUS OCP");
-		}
-		if(flag_readout[4] & (1 << 5)){
-			_Serial->println("BQ25672: Enter VBAT OVP");
-		}
-		if(flag_readout[4] & (1 << 6)){
-			_Serial->println("BQ25672: Enter VBUS OVP");
-		}
-		if(flag_readout[4] & (1 << 7)){
-			_Serial->println("BQ25672: Enter or exit IBAT regulation");
-		}
+bool BQ25672::readStatusSnapshot(BQ25672StatusSnapshot *snapshot){
+	// Reads all status registers in one burst
+	bool success = read_burst(0x1b, snapshot->status, BQ25672_STATUS_REGISTER_COUNT);
+	snapshot->timestamp = millis();
+	return success;
+}
 
-		if(flag_readout[5] & (1 << 0)){
-			_Serial->println("BQ25672: Reserved");
-		}
-		if(flag_readout[5] & (1 << 1)){
-			_Serial->println("BQ25672: Reserved");
-		}
-		if(flag_readout[5] & (1 << 2)){
-			_Serial->println("BQ25672: TS shutdown signal rising threshold detected");
-		}
-		if(flag_readout[5] & (1 << 3)){
-			_Serial->println("BQ25672: Reserved");
-		}
-		if(flag_readout[5] & (1 << 4)){
-			_Serial->println("BQ25672: Stop OTG due to VBUS under-voltage");
-		}
-		if(flag_readout[5] & (1 << 5)){
-			_Serial->println("BQ25672: Stop OTG due to VBUS over voltage");
-		}
-		if(flag_readout[5] & (1 << 6)){
-			_Serial->println("BQ25672: Stop switching due to system over-voltage");
-		}
-		if(flag_readout[5] & (1 << 7)){
-			_Serial->println("BQ25672: Stop switching due to system short");
-		}
+bool BQ25672::readAdcSnapshot(BQ25672AdcSnapshot *snapshot){
+	// Reads all ADC registers in one burst
+	uint8_t data[2 * BQ25672_ADC_CHANNEL_COUNT];
+	bool success = read_burst(0x31, data, sizeof(data));
+	snapshot->timestamp = millis();
+
+	if(!success){
+		return false;
+	}
 
+	int32_t val[BQ25672_ADC_CHANNEL_COUNT];
+	for(int i = 0; i < BQ25672_ADC_CHANNEL_COUNT; i++){
+		uint16_t raw = (data[2 * i] << 8) | data[2 * i + 1];
+		bool is_signed = i == BQ25672_ADC_IBUS || i == BQ25672_ADC_IBAT || i == BQ25672_ADC_TDIE;  // 2'complement channels
+		val[i] = calibrate(i, is_signed ? (int32_t)(int16_t) raw : (int32_t) raw);
 	}
-	return success;
+
+	snapshot->input_current = val[BQ25672_ADC_IBUS];
+	snapshot->battery_current = val[BQ25672_ADC_IBAT];
+	snapshot->bus_voltage = val[BQ25672_ADC_VBUS];
+	snapshot->input1_voltage = val[BQ25672_ADC_VAC1];
+	snapshot->input2_voltage = val[BQ25672_ADC_VAC2];
+	snapshot->battery_voltage = val[BQ25672_ADC_VBAT];
+	snapshot->system_voltage = val[BQ25672_ADC_VSYS];
+	snapshot->ntc_code = val[BQ25672_ADC_TS];
+	snapshot->die_temperature = val[BQ25672_ADC_TDIE];
+	snapshot->dp_voltage = val[BQ25672_ADC_DP];
+	snapshot->dn_voltage = val[BQ25672_ADC_DN];
+	return true;
+}
+
+uint64_t BQ25672::getStatusBits(const BQ25672StatusSnapshot *snapshot){
+	// Bit (8 * n + bit) is bit of register 0x1B + n
+	uint64_t bits = 0;
+	for(int i = 0; i < BQ25672_STATUS_REGISTER_COUNT; i++){
+		bits |= (uint64_t) snapshot->status[i] << (8 * i);
+	}
+	return bits;
+}
+
+uint8_t BQ25672::getStatusFieldWidth(uint8_t field){
+	// Returns 0 for bits that do not start a field
+	if(field >= BQ25672_STATUS_BIT_COUNT || !((BQ25672_STATUS_FIELD_STARTS >> field) & 1)) return 0;
+
+	switch(field){
+		case BQ25672_STATUS_VBUS_STATUS: return 4;
+		case BQ25672_STATUS_CHARGE_STATUS: return 3;
+		case BQ25672_STATUS_ICO_STATUS: return 2;
+		default: return 1;
+	}
+}
+
+uint8_t BQ25672::getStatusField(const BQ25672StatusSnapshot *snapshot, uint8_t field){
+	uint8_t width = getStatusFieldWidth(field);
+	if(width == 0) return 0;
+
+	return (snapshot->status[field >> 3] >> (field & 7)) & ((1 << width) - 1);
 }
 
 
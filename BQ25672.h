@@ -13,6 +13,138 @@
 #include <Arduino.h>
 #include <Wire.h>
 
+class BQ25672Calibration;
+class BQ25672EventDispatcher;
+class BQ25672FlagStatistics;
+class BQ25672WatchdogKeepalive;
+class BQ25672ChargeProfile;
+
+// Interrupt events, numbered as bit (8 * n + bit) of flag register 0x22 + n
+// and mask register 0x28 + n
+enum BQ25672Event : uint8_t {
+	BQ25672_EVENT_VBUS_PRESENT = 0,
+	BQ25672_EVENT_AC1_PRESENT = 1,
+	BQ25672_EVENT_AC2_PRESENT = 2,
+	BQ25672_EVENT_POWER_GOOD = 3,
+	BQ25672_EVENT_POOR_SOURCE = 4,
+	BQ25672_EVENT_WATCHDOG = 5,
+	BQ25672_EVENT_VINDPM = 6,
+	BQ25672_EVENT_IINDPM = 7,
+	BQ25672_EVENT_BC12_DONE = 8,
+	BQ25672_EVENT_BATTERY_PRESENT = 9,
+	BQ25672_EVENT_THERMAL_REGULATION = 10,
+	BQ25672_EVENT_VBUS_STATUS = 12,
+	BQ25672_EVENT_ICO = 14,
+	BQ25672_EVENT_CHARGE_STATUS = 15,
+	BQ25672_EVENT_TOPOFF_TIMER = 16,
+	BQ25672_EVENT_PRECHARGE_TIMER = 17,
+	BQ25672_EVENT_TRICKLE_TIMER = 18,
+	BQ25672_EVENT_FAST_CHARGE_TIMER = 19,
+	BQ25672_EVENT_VSYS_REGULATION = 20,
+	BQ25672_EVENT_ADC_DONE = 21,
+	BQ25672_EVENT_DPDM_DONE = 22,
+	BQ25672_EVENT_TS_HOT = 24,
+	BQ25672_EVENT_TS_WARM = 25,
+	BQ25672_EVENT_TS_COOL = 26,
+	BQ25672_EVENT_TS_COLD = 27,
+	BQ25672_EVENT_VBAT_OTG_LOW = 28,
+	BQ25672_EVENT_VAC1_OVP = 32,
+	BQ25672_EVENT_VAC2_OVP = 33,
+	BQ25672_EVENT_CONVERTER_OCP = 34,
+	BQ25672_EVENT_IBAT_OCP = 35,
+	BQ25672_EVENT_IBUS_OCP = 36,
+	BQ25672_EVENT_VBAT_OVP = 37,
+	BQ25672_EVENT_VBUS_OVP = 38,
+	BQ25672_EVENT_IBAT_REGULATION = 39,
+	BQ25672_EVENT_TS_SHUTDOWN = 42,
+	BQ25672_EVENT_OTG_UVP = 44,
+	BQ25672_EVENT_OTG_OVP = 45,
+	BQ25672_EVENT_VSYS_OVP = 46,
+	BQ25672_EVENT_VSYS_SHORT = 47,
+	BQ25672_EVENT_COUNT = 48
+};
+
+typedef uint64_t BQ25672EventSet;
+
+#define BQ25672_EVENT_BIT(event) ((BQ25672EventSet) 1 << (event))
+#define BQ25672_EVENTS_ALL ((BQ25672EventSet) 0xF4FF1F7FD7FFULL)  // All non-reserved bits
+
+#define BQ25672_STATUS_REGISTER_COUNT 7
+
+// Raw copy of status registers 0x1B..0x21
+struct BQ25672StatusSnapshot {
+	uint32_t timestamp;  // millis() at readout
+	uint8_t status[BQ25672_STATUS_REGISTER_COUNT];
+};
+
+// Fields of the status snapshot, numbered as their lowest bit (8 * n + bit) of register 0x1B + n
+enum BQ25672StatusField : uint8_t {
+	BQ25672_STATUS_VBUS_PRESENT = 0,
+	BQ25672_STATUS_AC1_PRESENT = 1,
+	BQ25672_STATUS_AC2_PRESENT = 2,
+	BQ25672_STATUS_POWER_GOOD = 3,
+	BQ25672_STATUS_WATCHDOG_EXPIRED = 5,
+	BQ25672_STATUS_VINDPM = 6,
+	BQ25672_STATUS_IINDPM = 7,
+	BQ25672_STATUS_BC12_DONE = 8,
+	BQ25672_STATUS_VBUS_STATUS = 9,  // 4 bits, see getBusVoltageStatus()
+	BQ25672_STATUS_CHARGE_STATUS = 13,  // 3 bits, see getChargeStatus()
+	BQ25672_STATUS_BATTERY_PRESENT = 16,
+	BQ25672_STATUS_DPDM_BUSY = 17,
+	BQ25672_STATUS_THERMAL_REGULATION = 18,
+	BQ25672_STATUS_ICO_STATUS = 22,  // 2 bits, see getIcoStatus()
+	BQ25672_STATUS_PRECHARGE_TIMER_EXPIRED = 25,
+	BQ25672_STATUS_TRICKLE_TIMER_EXPIRED = 26,
+	BQ25672_STATUS_FAST_CHARGE_TIMER_EXPIRED = 27,
+	BQ25672_STATUS_VSYS_REGULATION = 28,
+	BQ25672_STATUS_ADC_DONE = 29,
+	BQ25672_STATUS_INPUT_FETS1_PLACED = 30,
+	BQ25672_STATUS_INPUT_FETS2_PLACED = 31,
+	BQ25672_STATUS_TS_HOT = 32,
+	BQ25672_STATUS_TS_WARM = 33,
+	BQ25672_STATUS_TS_COOL = 34,
+	BQ25672_STATUS_TS_COLD = 35,
+	BQ25672_STATUS_VBAT_OTG_LOW = 36,
+	BQ25672_STATUS_VAC1_OVP = 40,
+	BQ25672_STATUS_VAC2_OVP = 41,
+	BQ25672_STATUS_CONVERTER_OCP = 42,
+	BQ25672_STATUS_IBAT_OCP = 43,
+	BQ25672_STATUS_IBUS_OCP = 44,
+	BQ25672_STATUS_VBAT_OVP = 45,
+	BQ25672_STATUS_VBUS_OVP = 46,
+	BQ25672_STATUS_IBAT_REGULATION = 47,
+	BQ25672_STATUS_TS_SHUTDOWN = 50,
+	BQ25672_STATUS_OTG_UVP = 52,
+	BQ25672_STATUS_OTG_OVP = 53,
+	BQ25672_STATUS_VSYS_OVP = 54,
+	BQ25672_STATUS_VSYS_SHORT = 55,
+	BQ25672_STATUS_BIT_COUNT = 56
+};
+
+// Decoded copy of ADC registers 0x31..0x46, calibration applied
+struct BQ25672AdcSnapshot {
+	uint32_t timestamp;  // millis() at readout
+	int16_t input_current;  // mA
+	int16_t battery_current;  // mA, negative when discharging
+	uint16_t bus_voltage;  // mV
+	uint16_t input1_voltage;  // mV
+	uint16_t input2_voltage;  // mV
+	uint16_t battery_voltage;  // mV
+	uint16_t system_voltage;  // mV
+	uint16_t ntc_code;  // 0.0976563 % of REGN
+	int16_t die_temperature;  // 0.5 C
+	uint16_t dp_voltage;  // mV
+	uint16_t dn_voltage;  // mV
+};
+
+#define BQ25672_STATUS_BITS_VALID 0xF4FF1FFEC7FFEFULL  // All non-reserved status bits
+#define BQ25672_STATUS_FIELD_STARTS 0xF4FF1FFE4723EFULL  // Lowest bit of every field
+
+// Called with lock = true before and lock = false after every register
+// access, a read-modify-write included. Needed when the charger is used from
+// more than one task, see BQ25672InterruptTask.
+typedef void (*BQ25672BusLockFunction)(bool lock, void *context);
+
 class BQ25672 {
 public:
     BQ25672();
@@ -25,6 +157,29 @@ public:
     int begin(TwoWire *i2c_bus, int sda, int scl, uint32_t frequency=0);
 
     bool readFlags();
+    BQ25672EventSet getFlags();
+    static const char *getEventName(uint8_t event);
+    void setEventDispatcher(BQ25672EventDispatcher *dispatcher);
+    void setFlagStatistics(BQ25672FlagStatistics *statistics);
+
+    bool readStatusSnapshot(BQ25672StatusSnapshot *snapshot);
+    bool readAdcSnapshot(BQ25672AdcSnapshot *snapshot);
+    static uint64_t getStatusBits(const BQ25672StatusSnapshot *snapshot);
+    static uint8_t getStatusFieldWidth(uint8_t field);
+    static uint8_t getStatusField(const BQ25672StatusSnapshot *snapshot, uint8_t field);
+
+    void setCalibration(BQ25672Calibration *calibration);
+    BQ25672Calibration *getCalibration();
+
+    bool subscribe(BQ25672EventSet events);
+    BQ25672EventSet getSubscribedEvents();
+
+    // Raw access to byte_cnt consecutive registers in bursts
+    bool readRegisters(uint8_t reg, uint8_t *data, uint8_t byte_cnt);
+    bool writeRegisters(uint8_t reg, const uint8_t *data, uint8_t byte_cnt);
+    void setWatchdogKeepalive(BQ25672WatchdogKeepalive *keepalive);
+    void setBusLock(BQ25672BusLockFunction lock_function, void *context = NULL);
+    bool applyProfile(BQ25672ChargeProfile *profile);
 
 	int getMinSystemVoltage();
 	bool setMinSystemVoltage(int new_value);
@@ -228,6 +383,84 @@ public:
 	uint8_t getChargerFlag3();
 	uint8_t getFaultFlag0();
 	uint8_t getFaultFlag();
+	bool getBusVoltagePresentInterruptMasked();
+	bool setBusVoltagePresentInterruptMasked(bool new_value);
+	bool getInput1PresentInterruptMasked();
+	bool setInput1PresentInterruptMasked(bool new_value);
+	bool getInput2PresentInterruptMasked();
+	bool setInput2PresentInterruptMasked(bool new_value);
+	bool getPowerGoodInterruptMasked();
+	bool setPowerGoodInterruptMasked(bool new_value);
+	bool getPoorSourceInterruptMasked();
+	bool setPoorSourceInterruptMasked(bool new_value);
+	bool getWatchdogTimerInterruptMasked();
+	bool setWatchdogTimerInterruptMasked(bool new_value);
+	bool getVindpmRegulationInterruptMasked();
+	bool setVindpmRegulationInterruptMasked(bool new_value);
+	bool getIindpmRegulationInterruptMasked();
+	bool setIindpmRegulationInterruptMasked(bool new_value);
+	bool getUsbBc12DoneInterruptMasked();
+	bool setUsbBc12DoneInterruptMasked(bool new_value);
+	bool getBatteryPresentInterruptMasked();
+	bool setBatteryPresentInterruptMasked(bool new_value);
+	bool getThermalRegulationInterruptMasked();
+	bool setThermalRegulationInterruptMasked(bool new_value);
+	bool getBusVoltageStatusInterruptMasked();
+	bool setBusVoltageStatusInterruptMasked(bool new_value);
+	bool getIcoStatusInterruptMasked();
+	bool setIcoStatusInterruptMasked(bool new_value);
+	bool getChargeStatusInterruptMasked();
+	bool setChargeStatusInterruptMasked(bool new_value);
+	bool getTopOffTimerInterruptMasked();
+	bool setTopOffTimerInterruptMasked(bool new_value);
+	bool getPreChargeTimerInterruptMasked();
+	bool setPreChargeTimerInterruptMasked(bool new_value);
+	bool getTrickleChargeTimerInterruptMasked();
+	bool setTrickleChargeTimerInterruptMasked(bool new_value);
+	bool getFastChargeTimerInterruptMasked();
+	bool setFastChargeTimerInterruptMasked(bool new_value);
+	bool getMinSystemVoltageRegulationInterruptMasked();
+	bool setMinSystemVoltageRegulationInterruptMasked(bool new_value);
+	bool getAdcConversionDoneInterruptMasked();
+	bool setAdcConversionDoneInterruptMasked(bool new_value);
+	bool getDpdnDetectionDoneInterruptMasked();
+	bool setDpdnDetectionDoneInterruptMasked(bool new_value);
+	bool getBatteryHotInterruptMasked();
+	bool setBatteryHotInterruptMasked(bool new_value);
+	bool getBatteryWarmInterruptMasked();
+	bool setBatteryWarmInterruptMasked(bool new_value);
+	bool getBatteryCoolInterruptMasked();
+	bool setBatteryCoolInterruptMasked(bool new_value);
+	bool getBatteryColdInterruptMasked();
+	bool setBatteryColdInterruptMasked(bool new_value);
+	bool getBatteryUvloForOtgInterruptMasked();
+	bool setBatteryUvloForOtgInterruptMasked(bool new_value);
+	bool getInput1OvpInterruptMasked();
+	bool setInput1OvpInterruptMasked(bool new_value);
+	bool getInput2OvpInterruptMasked();
+	bool setInput2OvpInterruptMasked(bool new_value);
+	bool getConverterOcpInterruptMasked();
+	bool setConverterOcpInterruptMasked(bool new_value);
+	bool getBatteryCurrentOcpInterruptMasked();
+	bool setBatteryCurrentOcpInterruptMasked(bool new_value);
+	bool getBusCurrentOcpInterruptMasked();
+	bool setBusCurrentOcpInterruptMasked(bool new_value);
+	bool getBatteryVoltageOvpInterruptMasked();
+	bool setBatteryVoltageOvpInterruptMasked(bool new_value);
+	bool getBusVoltageOvpInterruptMasked();
+	bool setBusVoltageOvpInterruptMasked(bool new_value);
+	bool getBatteryDischargeCurrentRegulationInterruptMasked();
+	bool setBatteryDischargeCurrentRegulationInterruptMasked(bool new_value);
+	bool getThermalShutdownInterruptMasked();
+	bool setThermalShutdownInterruptMasked(bool new_value);
+	bool getOtgUnderVoltageInterruptMasked();
+	bool setOtgUnderVoltageInterruptMasked(bool new_value);
+	bool getOtgOverVoltageInterruptMasked();
+	bool setOtgOverVoltageInterruptMasked(bool new_value);
+	bool getSystemOverVoltageInterruptMasked();
+	bool setSystemOverVoltageInterruptMasked(bool new_value);
+	bool getSystemShortCircuitInterruptMasked();
+	bool setSystemShortCircuitInterruptMasked(bool new_value);
 	bool getStartAverageWithNewAdcConversion();
 	bool setStartAverageWithNewAdcConversion(bool new_value);
 	bool getRunningAverageEnabled();
@@ -268,6 +501,7 @@ public:
 	int getBatteryVoltage();
 	int getSystemVoltage();
 	float getNtcReading();
+	int getNtcReadingCode();
 	float getDieTemperature();
 	int getDpVoltage();
 	int getDnVoltage();
@@ -281,17 +515,33 @@ public:
 private:
 	uint16_t flag_readout[6] = {0};
     uint8_t flag_registers[6] = {0x22, 0x23, 0x24, 0x25, 0x26, 0x27};
+    BQ25672EventSet flag_set = 0;
+    uint8_t mask_registers[6] = {0x28, 0x29, 0x2A, 0x2B, 0x2C, 0x2D};
 
 	TwoWire *_bus;
 	HardwareSerial *_Serial;
+	BQ25672Calibration *_calibration;
+	BQ25672EventDispatcher *_dispatcher;
+	BQ25672FlagStatistics *_statistics;
+	BQ25672WatchdogKeepalive *_keepalive;
+	BQ25672BusLockFunction _bus_lock;
+	void *_bus_lock_context;
 	uint8_t _i2caddr;
 	unsigned int timeout_time;
 
 	bool read_bytes(uint8_t reg, uint16_t *data, uint8_t byte_cnt);
 	bool write_bytes(uint8_t reg, uint16_t data, uint8_t byte_cnt);
+	bool read_burst(uint8_t reg, uint8_t *data, uint8_t byte_cnt);
+	bool write_burst(uint8_t reg, const uint8_t *data, uint8_t byte_cnt);
+	bool read_chunks(uint8_t reg, uint8_t *data, uint8_t byte_cnt);
+	bool write_chunks(uint8_t reg, const uint8_t *data, uint8_t byte_cnt);
+	void lockBus(bool lock);
+	uint8_t outgoing(uint8_t reg, uint8_t data);
 
 	uint16_t read_var(uint8_t reg, uint8_t byte_cnt, uint8_t bit_start, uint8_t bit_end);
 
 	bool write_var(uint8_t reg, uint8_t byte_cnt, uint8_t bit_start, uint8_t bit_end, uint16_t new_data);
+
+	int32_t calibrate(uint8_t channel, int32_t raw);
 };
 #endif /* BQ25672_H_ */
\ No newline at end of file
@@ -0,0 +1,181 @@
+/*
+  FILE:    BQ25672Calibration.cpp
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Per-channel gain/offset calibration of the BQ25672 ADC readings
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#include "BQ25672Calibration.h"
+
+#define BQ25672_CALIBRATION_VERSION 1
+
+static int64_t divide_rounded(int64_t numerator, int64_t denominator){
+	if(denominator < 0){
+		numerator = -numerator;
+		denominator = -denominator;
+	}
+	if(numerator >= 0){
+		return (numerator + denominator / 2) / denominator;
+	}
+	return (numerator - denominator / 2) / denominator;
+}
+
+BQ25672Calibration::BQ25672Calibration() {
+	reset();
+}
+
+void BQ25672Calibration::reset(){
+	for(int i = 0; i < BQ25672_ADC_CHANNEL_COUNT; i++){
+		reset(i);
+	}
+}
+
+void BQ25672Calibration::reset(uint8_t channel){
+	if(channel >= BQ25672_ADC_CHANNEL_COUNT) return;
+
+	gain[channel] = BQ25672_CALIBRATION_GAIN_UNITY;
+	offset[channel] = 0;
+}
+
+bool BQ25672Calibration::setChannel(uint8_t channel, int16_t new_gain, int16_t new_offset){
+	if(channel >= BQ25672_ADC_CHANNEL_COUNT || new_gain <= 0) return false;
+
+	gain[channel] = new_gain;
+	offset[channel] = new_offset;
+	return true;
+}
+
+int16_t BQ25672Calibration::getGain(uint8_t channel){
+	// Returns value in: 1/16384
+
+	if(channel >= BQ25672_ADC_CHANNEL_COUNT) return BQ25672_CALIBRATION_GAIN_UNITY;
+	return gain[channel];
+}
+
+int16_t BQ25672Calibration::getOffset(uint8_t channel){
+	// Returns value in: ADC LSB
+
+	if(channel >= BQ25672_ADC_CHANNEL_COUNT) return 0;
+	return offset[channel];
+}
+
+bool BQ25672Calibration::fit(uint8_t channel, const int32_t *raw, const int32_t *reference, uint8_t count){
+	if(channel >= BQ25672_ADC_CHANNEL_COUNT || count < 2) return false;
+
+	int64_t sum_x = 0;
+	int64_t sum_y = 0;
+	int64_t sum_xx = 0;
+	int64_t sum_xy = 0;
+
+	for(int i = 0; i < count; i++){
+		sum_x += raw[i];
+		sum_y += reference[i];
+		sum_xx += (int64_t) raw[i] * raw[i];
+		sum_xy += (int64_t) raw[i] * reference[i];
+	}
+
+	int64_t numerator = count * sum_xy - sum_x * sum_y;
+	int64_t denominator = count * sum_xx - sum_x * sum_x;
+	if(denominator == 0){
+		// All raw points are equal, the gain cannot be determined
+		return false;
+	}
+
+	int64_t new_gain = divide_rounded(numerator * BQ25672_CALIBRATION_GAIN_UNITY, denominator);
+	if(new_gain <= 0 || new_gain > INT16_MAX){
+		return false;
+	}
+
+	int64_t new_offset = divide_rounded(sum_y * BQ25672_CALIBRATION_GAIN_UNITY - new_gain * sum_x, (int64_t) count * BQ25672_CALIBRATION_GAIN_UNITY);
+	if(new_offset < INT16_MIN || new_offset > INT16_MAX){
+		return false;
+	}
+
+	gain[channel] = (int16_t) new_gain;
+	offset[channel] = (int16_t) new_offset;
+	return true;
+}
+
+bool BQ25672Calibration::fit(uint8_t channel, int32_t raw1, int32_t reference1, int32_t raw2, int32_t reference2){
+	int32_t raw[2] = {raw1, raw2};
+	int32_t reference[2] = {reference1, reference2};
+	return fit(channel, raw, reference, 2);
+}
+
+uint8_t BQ25672Calibration::serialize(uint8_t *buffer, uint8_t size){
+	// Layout: version, channel mask (LE), [gain (LE), offset (LE)] per calibrated channel, CRC-8
+	// Channels with unity gain and zero offset are left out
+	// Returns the number of bytes written, 0 if the buffer is too small
+
+	uint16_t channel_mask = 0;
+	uint8_t length = 4;
+	for(int i = 0; i < BQ25672_ADC_CHANNEL_COUNT; i++){
+		if(gain[i] != BQ25672_CALIBRATION_GAIN_UNITY || offset[i] != 0){
+			channel_mask |= 1 << i;
+			length += 4;
+		}
+	}
+	if(size < length) return 0;
+
+	uint8_t pos = 0;
+	buffer[pos++] = BQ25672_CALIBRATION_VERSION;
+	buffer[pos++] = channel_mask & 0xFF;
+	buffer[pos++] = channel_mask >> 8;
+	for(int i = 0; i < BQ25672_ADC_CHANNEL_COUNT; i++){
+		if(channel_mask & (1 << i)){
+			buffer[pos++] = (uint16_t) gain[i] & 0xFF;
+			buffer[pos++] = (uint16_t) gain[i] >> 8;
+			buffer[pos++] = (uint16_t) offset[i] & 0xFF;
+			buffer[pos++] = (uint16_t) offset[i] >> 8;
+		}
+	}
+	buffer[pos] = crc8(buffer, pos);
+	return length;
+}
+
+bool BQ25672Calibration::deserialize(const uint8_t *buffer, uint8_t size){
+	if(size < 4 || buffer[0] != BQ25672_CALIBRATION_VERSION) return false;
+
+	uint16_t channel_mask = buffer[1] | (buffer[2] << 8);
+	if(channel_mask >> BQ25672_ADC_CHANNEL_COUNT) return false;
+
+	uint8_t length = 4;
+	for(int i = 0; i < BQ25672_ADC_CHANNEL_COUNT; i++){
+		if(channel_mask & (1 << i)) length += 4;
+	}
+	if(size < length || crc8(buffer, length - 1) != buffer[length - 1]) return false;
+
+	// Same gain check as setChannel(), before anything is changed
+	uint8_t pos = 3;
+	for(int i = 0; i < BQ25672_ADC_CHANNEL_COUNT; i++){
+		if(channel_mask & (1 << i)){
+			if((int16_t)(buffer[pos] | (buffer[pos + 1] << 8)) <= 0) return false;
+			pos += 4;
+		}
+	}
+
+	reset();
+	pos = 3;
+	for(int i = 0; i < BQ25672_ADC_CHANNEL_COUNT; i++){
+		if(channel_mask & (1 << i)){
+			gain[i] = (int16_t)(buffer[pos] | (buffer[pos + 1] << 8));
+			offset[i] = (int16_t)(buffer[pos + 2] | (buffer[pos + 3] << 8));
+			pos += 4;
+		}
+	}
+	return true;
+}
+
+uint8_t BQ25672Calibration::crc8(const uint8_t *data, uint8_t length){
+	// CRC-8, polynomial 0x07
+	uint8_t crc = 0;
+	for(int i = 0; i < length; i++){
+		crc ^= data[i];
+		for(int bit = 0; bit < 8; bit++){
+			crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+		}
+	}
+	return crc;
+}
@@ -0,0 +1,66 @@
+/*
+  FILE:    BQ25672Calibration.h
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Per-channel gain/offset calibration of the BQ25672 ADC readings
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#ifndef BQ25672_CALIBRATION_H_
+#define BQ25672_CALIBRATION_H_
+
+#include <Arduino.h>
+
+// ADC channels in register order, channel n is read from register 0x31 + 2 * n
+enum BQ25672AdcChannel : uint8_t {
+	BQ25672_ADC_IBUS = 0,
+	BQ25672_ADC_IBAT,
+	BQ25672_ADC_VBUS,
+	BQ25672_ADC_VAC1,
+	BQ25672_ADC_VAC2,
+	BQ25672_ADC_VBAT,
+	BQ25672_ADC_VSYS,
+	BQ25672_ADC_TS,
+	BQ25672_ADC_TDIE,
+	BQ25672_ADC_DP,
+	BQ25672_ADC_DN,
+	BQ25672_ADC_CHANNEL_COUNT
+};
+
+#define BQ25672_CALIBRATION_GAIN_SHIFT 14
+#define BQ25672_CALIBRATION_GAIN_UNITY (1 << BQ25672_CALIBRATION_GAIN_SHIFT)
+
+// Version + channel bit mask + 4 bytes per calibrated channel + CRC-8
+#define BQ25672_CALIBRATION_BLOB_MAX_SIZE (3 + 4 * BQ25672_ADC_CHANNEL_COUNT + 1)
+
+class BQ25672Calibration {
+public:
+	BQ25672Calibration();
+
+	void reset();
+	void reset(uint8_t channel);
+
+	// gain in units of 1/16384, offset in ADC LSB
+	bool setChannel(uint8_t channel, int16_t gain, int16_t offset);
+	int16_t getGain(uint8_t channel);
+	int16_t getOffset(uint8_t channel);
+
+	// Least squares fit of reference = gain * raw + offset, both in ADC LSB
+	bool fit(uint8_t channel, const int32_t *raw, const int32_t *reference, uint8_t count);
+	bool fit(uint8_t channel, int32_t raw1, int32_t reference1, int32_t raw2, int32_t reference2);
+
+	uint8_t serialize(uint8_t *buffer, uint8_t size);
+	bool deserialize(const uint8_t *buffer, uint8_t size);
+
+	int32_t apply(uint8_t channel, int32_t raw) const {
+		return (((int32_t) raw * gain[channel] + (1 << (BQ25672_CALIBRATION_GAIN_SHIFT - 1))) >> BQ25672_CALIBRATION_GAIN_SHIFT) + offset[channel];
+	}
+
+private:
+	int16_t gain[BQ25672_ADC_CHANNEL_COUNT];
+	int16_t offset[BQ25672_ADC_CHANNEL_COUNT];
+
+	static uint8_t crc8(const uint8_t *data, uint8_t length);
+};
+#endif /* BQ25672_CALIBRATION_H_ */
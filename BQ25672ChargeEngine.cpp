@@ -0,0 +1,177 @@
+/*
+  FILE:    BQ25672ChargeEngine.cpp
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Table driven multi-stage charging on top of the BQ25672 CC/CV charger
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#include "BQ25672ChargeEngine.h"
+
+#define CHARGE_STATUS_NOT_CHARGING 0
+#define CHARGE_STATUS_DONE 7
+
+BQ25672ChargeEngine::BQ25672ChargeEngine(BQ25672 *charger, BQ25672SocEstimator *soc):
+	_charger(charger), _arbiter(NULL), _soc(soc), _stages(NULL), stage_count(0),
+	stage(0), stage_start(0), debounce(0), pulse_on(true), pulse_start(0),
+	written_current(-1), written_voltage(-1), written_enabled(-1), write_count(0), write_errors(0) {
+}
+
+void BQ25672ChargeEngine::setLimitArbiter(BQ25672LimitArbiter *arbiter){
+	_arbiter = arbiter;
+}
+
+bool BQ25672ChargeEngine::begin(const BQ25672ChargeStage *stages, uint8_t new_stage_count, uint32_t now){
+	// Without stages the engine stays idle and leaves the charger alone
+	_stages = new_stage_count > 0 ? stages : NULL;
+	stage_count = _stages != NULL ? new_stage_count : 0;
+	if(_stages == NULL) return false;
+
+	// The register state is unknown, write everything once
+	written_current = -1;
+	written_voltage = -1;
+	written_enabled = -1;
+	return restart(now);
+}
+
+bool BQ25672ChargeEngine::restart(uint32_t now){
+	if(_stages == NULL) return false;
+	return enterStage(0, now);
+}
+
+bool BQ25672ChargeEngine::update(const BQ25672AdcSnapshot *adc, const BQ25672StatusSnapshot *status){
+	if(_stages == NULL) return true;  // begin() has not run
+	if(isFinished()){
+		// Retries the charging disable of enterStage() until it succeeded
+		if(written_enabled != 0) return writeSettings(written_current, written_voltage, false);
+		return true;
+	}
+
+	uint32_t now = adc->timestamp;
+	const BQ25672ChargeStage *current = &_stages[stage];
+
+	bool timed_out = current->timeout != 0 && now - stage_start >= current->timeout;
+	if(exitReached(current, adc, status)){
+		debounce++;
+	}
+	else{
+		debounce = 0;
+	}
+
+	if(timed_out || debounce >= BQ25672_STAGE_DEBOUNCE){
+		return enterStage(stage + 1, now);
+	}
+
+	if(current->pulse_on != 0){
+		// Pulse charging toggles charging enabled
+		uint32_t phase_time = pulse_on ? current->pulse_on : current->pulse_off;
+		if(now - pulse_start >= phase_time){
+			pulse_on = !pulse_on;
+			pulse_start = now;
+		}
+	}
+
+	// Only writes what changed, also retries failed writes
+	return writeSettings(current->charge_current, current->charge_voltage, pulse_on);
+}
+
+uint8_t BQ25672ChargeEngine::getStage(){
+	return stage;
+}
+
+bool BQ25672ChargeEngine::isFinished(){
+	return stage >= stage_count;
+}
+
+bool BQ25672ChargeEngine::isPulseOn(){
+	return pulse_on;
+}
+
+uint32_t BQ25672ChargeEngine::getStageTime(uint32_t now){
+	// Returns value in: ms
+	return now - stage_start;
+}
+
+uint32_t BQ25672ChargeEngine::getWriteCount(){
+	return write_count;
+}
+
+uint32_t BQ25672ChargeEngine::getWriteErrorCount(){
+	return write_errors;
+}
+
+bool BQ25672ChargeEngine::exitReached(const BQ25672ChargeStage *current, const BQ25672AdcSnapshot *adc, const BQ25672StatusSnapshot *status){
+	switch(current->exit_condition){
+		case BQ25672_STAGE_EXIT_VOLTAGE:
+			return adc->battery_voltage >= current->exit_value;
+		case BQ25672_STAGE_EXIT_CURRENT:
+			// Only while charging: the off phase of a pulse has no taper, and neither
+			// does a discharge after the adapter is removed
+			if(!pulse_on || adc->battery_current < 0) return false;
+			if(status != NULL && BQ25672::getStatusField(status, BQ25672_STATUS_CHARGE_STATUS) == CHARGE_STATUS_NOT_CHARGING) return false;
+			return adc->battery_current <= (int16_t) current->exit_value;
+		case BQ25672_STAGE_EXIT_SOC:
+			return _soc != NULL && _soc->getSoc() >= current->exit_value;
+		case BQ25672_STAGE_EXIT_CHARGE_DONE:
+			return status != NULL && BQ25672::getStatusField(status, BQ25672_STATUS_CHARGE_STATUS) == CHARGE_STATUS_DONE;
+		default:
+			return false;
+	}
+}
+
+bool BQ25672ChargeEngine::enterStage(uint8_t new_stage, uint32_t now){
+	stage = new_stage;
+	stage_start = now;
+	debounce = 0;
+	pulse_on = true;
+	pulse_start = now;
+
+	if(isFinished()){
+		// Keep the settings of the last stage, only stop charging
+		return writeSettings(written_current, written_voltage, false);
+	}
+	return writeSettings(_stages[stage].charge_current, _stages[stage].charge_voltage, true);
+}
+
+bool BQ25672ChargeEngine::writeSettings(int current, int voltage, bool enabled){
+	// Only the changed fields are set, apply() then writes them in as few
+	// bursts as possible: ICHG and VREG are neighbours, EN_CHG is not.
+	// With an arbiter ICHG is requested from it instead.
+	BQ25672ChargeProfile profile;
+	bool changed = false;
+
+	if(current != written_current){
+		if(_arbiter != NULL){
+			if(!_arbiter->request(BQ25672_LIMIT_CHARGE_CURRENT, BQ25672_LIMIT_CLIENT_CHARGE_ENGINE, current)) return writeFailed();
+			written_current = current;
+		}
+		else if(!profile.setChargeCurrent(current)){
+			return writeFailed();
+		}
+		changed = true;
+	}
+	if(voltage != written_voltage){
+		if(!profile.setChargeVoltage(voltage)) return writeFailed();
+		changed = true;
+	}
+	if(enabled != written_enabled){
+		profile.setChargingEnabled(enabled);
+		changed = true;
+	}
+	if(!changed) return true;
+
+	if(_charger != NULL && !profile.apply(_charger)) return writeFailed();
+
+	written_current = current;
+	written_voltage = voltage;
+	written_enabled = enabled;
+	write_count++;
+	return true;
+}
+
+bool BQ25672ChargeEngine::writeFailed(){
+	// The written values stay as they were, the next update retries
+	write_errors++;
+	return false;
+}
@@ -0,0 +1,85 @@
+/*
+  FILE:    BQ25672ChargeEngine.h
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Table driven multi-stage charging on top of the BQ25672 CC/CV charger
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#ifndef BQ25672_CHARGE_ENGINE_H_
+#define BQ25672_CHARGE_ENGINE_H_
+
+#include "BQ25672.h"
+#include "BQ25672LimitArbiter.h"
+#include "BQ25672SocEstimator.h"
+#include "BQ25672ChargeProfile.h"
+
+// Condition that ends a stage, next to the optional timeout
+#define BQ25672_STAGE_EXIT_NONE 0  // Stay in the stage, e.g. storage charging
+#define BQ25672_STAGE_EXIT_VOLTAGE 1  // VBAT >= exit_value mV
+#define BQ25672_STAGE_EXIT_CURRENT 2  // 0 <= IBAT <= exit_value mA while charging, the taper of a CV stage
+#define BQ25672_STAGE_EXIT_SOC 3  // State of charge >= exit_value 0.1 %, needs a BQ25672SocEstimator
+#define BQ25672_STAGE_EXIT_TIME 4  // Only the timeout
+#define BQ25672_STAGE_EXIT_CHARGE_DONE 5  // Charge status is "Charge done"
+
+#define BQ25672_STAGE_DEBOUNCE 3  // Consecutive snapshots the exit condition must hold
+
+struct BQ25672ChargeStage {
+	uint16_t charge_current;  // mA
+	uint16_t charge_voltage;  // mV, caps the stage with the CV loop of the charger
+	uint8_t exit_condition;
+	uint16_t exit_value;
+	uint16_t pulse_on;  // ms charging, 0 = continuous
+	uint16_t pulse_off;  // ms not charging
+	uint32_t timeout;  // ms, 0 = none
+};
+
+// Runs a table of stages from the ADC and status snapshot stream. Every
+// update only evaluates the exit condition of the current stage and moves at
+// most one stage on. Charge current, charge voltage and charging enabled are
+// only written when they change, all changes of one update as one profile
+// apply. After the last stage charging is disabled, a failed disable is
+// retried on the next update.
+class BQ25672ChargeEngine {
+public:
+	BQ25672ChargeEngine(BQ25672 *charger, BQ25672SocEstimator *soc = NULL);  // charger may be NULL for simulations
+	void setLimitArbiter(BQ25672LimitArbiter *arbiter);  // NULL = write the registers directly
+
+	bool begin(const BQ25672ChargeStage *stages, uint8_t stage_count, uint32_t now);  // false for an empty table
+	bool restart(uint32_t now);
+
+	bool update(const BQ25672AdcSnapshot *adc, const BQ25672StatusSnapshot *status = NULL);  // Returns false on a write error
+
+	uint8_t getStage();  // Index in the table, stage_count when finished
+	bool isFinished();
+	bool isPulseOn();
+	uint32_t getStageTime(uint32_t now);  // ms in the current stage
+	uint32_t getWriteCount();  // Profile applies
+	uint32_t getWriteErrorCount();
+
+private:
+	BQ25672 *_charger;
+	BQ25672LimitArbiter *_arbiter;
+	BQ25672SocEstimator *_soc;
+	const BQ25672ChargeStage *_stages;
+	uint8_t stage_count;
+
+	uint8_t stage;
+	uint32_t stage_start;
+	uint8_t debounce;
+	bool pulse_on;
+	uint32_t pulse_start;
+
+	int written_current;
+	int written_voltage;
+	int8_t written_enabled;  // -1 = unknown
+	uint32_t write_count;
+	uint32_t write_errors;
+
+	bool exitReached(const BQ25672ChargeStage *current, const BQ25672AdcSnapshot *adc, const BQ25672StatusSnapshot *status);
+	bool enterStage(uint8_t new_stage, uint32_t now);
+	bool writeSettings(int current, int voltage, bool enabled);
+	bool writeFailed();
+};
+#endif /* BQ25672_CHARGE_ENGINE_H_ */
@@ -0,0 +1,331 @@
+/*
+  FILE:    BQ25672ChargeProfile.cpp
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Complete BQ25672 configuration applied as one atomic change
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#include "BQ25672ChargeProfile.h"
+
+#define NO_SPAN 0xFF
+
+BQ25672ChargeProfile::BQ25672ChargeProfile():
+	written_registers(0), bursts(0) {
+	memset(span_first, NO_SPAN, sizeof(span_first));
+	memset(span_last, NO_SPAN, sizeof(span_last));
+}
+
+bool BQ25672ChargeProfile::load(BQ25672 *charger){
+	if(!image.read(charger)) return false;
+	memset(set_mask.data, 0xFF, sizeof(set_mask.data));
+	return true;
+}
+
+void BQ25672ChargeProfile::setImage(const BQ25672RegisterImage *new_image){
+	image = *new_image;
+	memset(set_mask.data, 0xFF, sizeof(set_mask.data));
+}
+
+const BQ25672RegisterImage *BQ25672ChargeProfile::getImage() const{
+	return &image;
+}
+
+bool BQ25672ChargeProfile::apply(BQ25672 *charger){
+	// Registers without set fields are not read and equal the profile image
+	BQ25672RegisterImage previous = image;
+	if(!readSetRegisters(charger, &previous)) return false;
+
+	// Bits outside the set fields keep their device value
+	BQ25672RegisterImage target;
+	for(int i = 0; i < BQ25672_IMAGE_SIZE; i++){
+		target.data[i] = (previous.data[i] & ~set_mask.data[i]) | (image.data[i] & set_mask.data[i]);
+	}
+
+	bool success = writeDifferences(charger, &target, &previous);
+	uint8_t applied_registers = written_registers;
+	uint8_t applied_bursts = bursts;
+
+	if(success && verify(charger, &target)){
+		return true;
+	}
+
+	// Restore every register that may have been changed
+	writeDifferences(charger, &previous, &target);
+	written_registers = applied_registers;
+	bursts = applied_bursts;
+	return false;
+}
+
+uint8_t BQ25672ChargeProfile::getWrittenRegisterCount(){
+	return written_registers;
+}
+
+uint8_t BQ25672ChargeProfile::getBurstCount(){
+	return bursts;
+}
+
+bool BQ25672ChargeProfile::setMinSystemVoltage(int new_value){
+	// Set value in: mV
+	return setScaled(0x0, 1, 0, 5, 2500, 250, new_value);
+}
+
+bool BQ25672ChargeProfile::setChargeVoltage(int new_value){
+	// Set value in: mV
+	return setScaled(0x1, 2, 0, 10, 0, 10, new_value);
+}
+
+bool BQ25672ChargeProfile::setChargeCurrent(int new_value){
+	// Set value in: mA
+	return setScaled(0x3, 2, 0, 8, 0, 10, new_value);
+}
+
+bool BQ25672ChargeProfile::setVindpmThreshold(int new_value){
+	// Set value in: mV
+	return setScaled(0x5, 1, 0, 7, 0, 100, new_value);
+}
+
+bool BQ25672ChargeProfile::setInputCurrentLimitRegister(int new_value){
+	// Set value in: mA
+	return setScaled(0x6, 2, 0, 8, 0, 10, new_value);
+}
+
+bool BQ25672ChargeProfile::setPreChargeCurrent(int new_value){
+	// Set value in: mA
+	return setScaled(0x8, 1, 0, 5, 0, 40, new_value);
+}
+
+bool BQ25672ChargeProfile::setTerminationCurrent(int new_value){
+	// Set value in: mA
+	return setScaled(0x9, 1, 0, 4, 0, 40, new_value);
+}
+
+bool BQ25672ChargeProfile::setWatchdogTimerDisablesCharging(bool new_value){
+	return setField(0x9, 1, 5, 5, new_value);
+}
+
+bool BQ25672ChargeProfile::setBatteryRechargeThreshold(int new_value){
+	// Set value in: mV
+	return setScaled(0xa, 1, 0, 3, 50, 50, new_value);
+}
+
+bool BQ25672ChargeProfile::setBatteryRechargeDeglitchTime(int new_value){
+	// Set value: see BQ25672::setBatteryRechargeDeglitchTime()
+	return setField(0xa, 1, 4, 5, new_value);
+}
+
+bool BQ25672ChargeProfile::setBatterySeriesCount(int new_value){
+	return setScaled(0xa, 1, 6, 7, 1, 1, new_value);
+}
+
+bool BQ25672ChargeProfile::setOtgVoltage(int new_value){
+	// Set value in: mV
+	return setScaled(0xb, 2, 0, 10, 2800, 10, new_value);
+}
+
+bool BQ25672ChargeProfile::setOtgCurrentLimit(int new_value){
+	// Set value in: mA
+	return setScaled(0xd, 1, 0, 6, 0, 40, new_value);
+}
+
+bool BQ25672ChargeProfile::setPreChargeTimer(int new_value){
+	// Set value: see BQ25672::setPreChargeTimer()
+	return setField(0xd, 1, 7, 7, new_value);
+}
+
+bool BQ25672ChargeProfile::setFastChargeTimer(int new_value){
+	// Set value: see BQ25672::setFastChargeTimer()
+	return setField(0xe, 1, 1, 2, new_value);
+}
+
+bool BQ25672ChargeProfile::setFastChargeTimerEnabled(bool new_value){
+	return setField(0xe, 1, 3, 3, new_value);
+}
+
+bool BQ25672ChargeProfile::setPreChargeTimerEnabled(bool new_value){
+	return setField(0xe, 1, 4, 4, new_value);
+}
+
+bool BQ25672ChargeProfile::setTrickleChargeTimerEnabled(bool new_value){
+	return setField(0xe, 1, 5, 5, new_value);
+}
+
+bool BQ25672ChargeProfile::setTopOffTimer(int new_value){
+	// Set value: see BQ25672::setTopOffTimer()
+	return setField(0xe, 1, 6, 7, new_value);
+}
+
+bool BQ25672ChargeProfile::setTerminationEnabled(bool new_value){
+	return setField(0xf, 1, 1, 1, new_value);
+}
+
+bool BQ25672ChargeProfile::setHizModeEnabled(bool new_value){
+	return setField(0xf, 1, 2, 2, new_value);
+}
+
+bool BQ25672ChargeProfile::setIcoEnabled(bool new_value){
+	return setField(0xf, 1, 4, 4, new_value);
+}
+
+bool BQ25672ChargeProfile::setChargingEnabled(bool new_value){
+	return setField(0xf, 1, 5, 5, new_value);
+}
+
+bool BQ25672ChargeProfile::setWatchdogTimerTime(int new_value){
+	// Set value: see BQ25672::setWatchdogTimerTime()
+	return setField(0x10, 1, 0, 2, new_value);
+}
+
+bool BQ25672ChargeProfile::setOtgControlEnabled(bool new_value){
+	return setField(0x12, 1, 6, 6, new_value);
+}
+
+bool BQ25672ChargeProfile::setMpptEnabled(bool new_value){
+	return setField(0x15, 1, 0, 0, new_value);
+}
+
+bool BQ25672ChargeProfile::setThermalRegulationThreshold(int new_value){
+	// Set value: see BQ25672::setThermalRegulationThreshold()
+	return setField(0x16, 1, 6, 7, new_value);
+}
+
+bool BQ25672ChargeProfile::setJeitaLowTemperatureChargeCurrentMultiplier(int new_value){
+	// Set value: see BQ25672::setJeitaLowTemperatureChargeCurrentMultiplier()
+	return setField(0x17, 1, 1, 2, new_value);
+}
+
+bool BQ25672ChargeProfile::setJeitaHighTemperatureChargeCurrentMultiplier(int new_value){
+	// Set value: see BQ25672::setJeitaHighTemperatureChargeCurrentMultiplier()
+	return setField(0x17, 1, 3, 4, new_value);
+}
+
+bool BQ25672ChargeProfile::setJeitaHighTempChargeVoltageOffset(int new_value){
+	// Set value: see BQ25672::setJeitaHighTempChargeVoltageOffset()
+	return setField(0x17, 1, 5, 7, new_value);
+}
+
+bool BQ25672ChargeProfile::setJeitaVt3Threshold(int new_value){
+	// Set value: see BQ25672::setJeitaVt3Threshold()
+	return setField(0x18, 1, 4, 5, new_value);
+}
+
+bool BQ25672ChargeProfile::setJeitaVt2Threshold(int new_value){
+	// Set value: see BQ25672::setJeitaVt2Threshold()
+	return setField(0x18, 1, 6, 7, new_value);
+}
+
+bool BQ25672ChargeProfile::setAdcEnabled(bool new_value){
+	return setField(0x2e, 1, 7, 7, new_value);
+}
+
+bool BQ25672ChargeProfile::setField(uint8_t reg, uint8_t byte_cnt, uint8_t bit_start, uint8_t bit_end, uint16_t new_data){
+	if(!image.setField(reg, byte_cnt, bit_start, bit_end, new_data)) return false;
+	return set_mask.setField(reg, byte_cnt, bit_start, bit_end, (1 << (bit_end - bit_start + 1)) - 1);
+}
+
+bool BQ25672ChargeProfile::setScaled(uint8_t reg, uint8_t byte_cnt, uint8_t bit_start, uint8_t bit_end, uint16_t offset, uint8_t lsb, int new_value){
+	if(new_value < offset){
+		// Data is out of range
+		return false;
+	}
+	return setField(reg, byte_cnt, bit_start, bit_end, (uint16_t)((new_value - offset) / lsb));
+}
+
+bool BQ25672ChargeProfile::readSetRegisters(BQ25672 *charger, BQ25672RegisterImage *current){
+	// One burst per block, from the first to the last register with a set field
+	int first = -1;
+	int last = -1;
+
+	for(int i = 0; i <= BQ25672_IMAGE_SIZE; i++){
+		bool block_end = i == BQ25672_IMAGE_SIZE || (i > 0 && BQ25672RegisterImage::registerAt(i) != BQ25672RegisterImage::registerAt(i - 1) + 1);
+		if(block_end && first >= 0){
+			if(!charger->readRegisters(BQ25672RegisterImage::registerAt(first), current->data + first, last - first + 1)) return false;
+			first = -1;
+		}
+		if(i == BQ25672_IMAGE_SIZE) break;
+		if(set_mask.data[i] == 0) continue;
+
+		// writeDifferences() writes both bytes of a two byte register
+		uint8_t reg = BQ25672RegisterImage::registerAt(i);
+		int low = i;
+		if(low > 0 && isWordStart(reg - 1) && BQ25672RegisterImage::registerAt(low - 1) == reg - 1) low--;
+		int high = i;
+		if(isWordStart(reg) && high + 1 < BQ25672_IMAGE_SIZE) high++;
+
+		if(first < 0) first = low;
+		last = high;
+	}
+	return true;
+}
+
+bool BQ25672ChargeProfile::writeDifferences(BQ25672 *charger, const BQ25672RegisterImage *target, const BQ25672RegisterImage *current){
+	uint8_t out[BQ25672_IMAGE_SIZE];
+	uint8_t block = 0;
+	bool success = true;
+
+	written_registers = 0;
+	bursts = 0;
+	memset(span_first, NO_SPAN, sizeof(span_first));
+	memset(span_last, NO_SPAN, sizeof(span_last));
+
+	for(int i = 0; i < BQ25672_IMAGE_SIZE; i++){
+		uint8_t reg = BQ25672RegisterImage::registerAt(i);
+		if(i > 0 && reg != BQ25672RegisterImage::registerAt(i - 1) + 1) block++;
+		if(!differs(target, current, i)) continue;
+
+		// Both bytes of a two byte register are written together
+		int first = i;
+		if(first > 0 && isWordStart(reg - 1) && BQ25672RegisterImage::registerAt(first - 1) == reg - 1) first--;
+
+		// Extend the burst over short gaps of equal registers, within the block
+		int last = i;
+		for(int j = i + 1; j < BQ25672_IMAGE_SIZE && j <= last + BQ25672_PROFILE_MERGE_GAP + 1; j++){
+			if(BQ25672RegisterImage::registerAt(j) != BQ25672RegisterImage::registerAt(j - 1) + 1) break;
+			if(differs(target, current, j)) last = j;
+		}
+		if(isWordStart(BQ25672RegisterImage::registerAt(last)) && last + 1 < BQ25672_IMAGE_SIZE) last++;
+
+		for(int j = first; j <= last; j++){
+			out[j] = target->data[j] & ~BQ25672RegisterImage::getVolatileMask(BQ25672RegisterImage::registerAt(j));
+		}
+		if(!charger->writeRegisters(BQ25672RegisterImage::registerAt(first), out + first, last - first + 1)){
+			success = false;
+		}
+
+		written_registers += last - first + 1;
+		bursts++;
+		if(span_first[block] == NO_SPAN) span_first[block] = first;
+		span_last[block] = last;
+		i = last;
+	}
+	return success;
+}
+
+bool BQ25672ChargeProfile::verify(BQ25672 *charger, const BQ25672RegisterImage *target){
+	uint8_t readback[BQ25672_IMAGE_SIZE];
+
+	for(int block = 0; block < BQ25672_IMAGE_BLOCK_COUNT; block++){
+		if(span_first[block] == NO_SPAN) continue;
+
+		uint8_t first = span_first[block];
+		uint8_t count = span_last[block] - first + 1;
+		if(!charger->readRegisters(BQ25672RegisterImage::registerAt(first), readback, count)) return false;
+
+		for(int i = 0; i < count; i++){
+			uint8_t mask = ~BQ25672RegisterImage::getVolatileMask(BQ25672RegisterImage::registerAt(first + i));
+			if((readback[i] & mask) != (target->data[first + i] & mask)) return false;
+		}
+	}
+	return true;
+}
+
+bool BQ25672ChargeProfile::differs(const BQ25672RegisterImage *a, const BQ25672RegisterImage *b, uint8_t index){
+	uint8_t mask = ~BQ25672RegisterImage::getVolatileMask(BQ25672RegisterImage::registerAt(index));
+	return (a->data[index] & mask) != (b->data[index] & mask);
+}
+
+bool BQ25672ChargeProfile::isWordStart(uint8_t reg){
+	// MSB of REG01 (VREG), REG03 (ICHG), REG06 (IINDPM) and REG0B (VOTG)
+	return reg == 0x01 || reg == 0x03 || reg == 0x06 || reg == 0x0B;
+}
@@ -0,0 +1,93 @@
+/*
+  FILE:    BQ25672ChargeProfile.h
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Complete BQ25672 configuration applied as one atomic change
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#ifndef BQ25672_CHARGE_PROFILE_H_
+#define BQ25672_CHARGE_PROFILE_H_
+
+#include "BQ25672.h"
+#include "BQ25672RegisterImage.h"
+
+// Equal registers between two differences up to this count are rewritten,
+// one longer burst is cheaper than a new transaction
+#define BQ25672_PROFILE_MERGE_GAP 2
+
+// The setters take the same values as those of BQ25672 but only change the
+// register image. apply() reads the registers that hold set fields, writes the
+// registers that differ in contiguous bursts, reads them back in one burst per
+// block and restores the previous image if the read back does not match.
+// Fields that were never set keep their device value, unless the profile
+// started from load() or setImage(), which count as setting every field.
+// Note that the charger itself updates VINDPM and IINDPM after input
+// detection, a profile applied right then may fail the verification.
+class BQ25672ChargeProfile {
+public:
+	BQ25672ChargeProfile();
+
+	bool load(BQ25672 *charger);  // Starts from the current configuration
+	void setImage(const BQ25672RegisterImage *image);
+	const BQ25672RegisterImage *getImage() const;
+
+	bool apply(BQ25672 *charger);
+
+	uint8_t getWrittenRegisterCount();  // Of the last apply()
+	uint8_t getBurstCount();  // Of the last apply(), writes only
+
+	bool setMinSystemVoltage(int new_value);
+	bool setChargeVoltage(int new_value);
+	bool setChargeCurrent(int new_value);
+	bool setVindpmThreshold(int new_value);
+	bool setInputCurrentLimitRegister(int new_value);
+	bool setPreChargeCurrent(int new_value);
+	bool setTerminationCurrent(int new_value);
+	bool setWatchdogTimerDisablesCharging(bool new_value);
+	bool setBatteryRechargeThreshold(int new_value);
+	bool setBatteryRechargeDeglitchTime(int new_value);
+	bool setBatterySeriesCount(int new_value);
+	bool setOtgVoltage(int new_value);
+	bool setOtgCurrentLimit(int new_value);
+	bool setPreChargeTimer(int new_value);
+	bool setFastChargeTimer(int new_value);
+	bool setFastChargeTimerEnabled(bool new_value);
+	bool setPreChargeTimerEnabled(bool new_value);
+	bool setTrickleChargeTimerEnabled(bool new_value);
+	bool setTopOffTimer(int new_value);
+	bool setTerminationEnabled(bool new_value);
+	bool setHizModeEnabled(bool new_value);
+	bool setIcoEnabled(bool new_value);
+	bool setChargingEnabled(bool new_value);
+	bool setWatchdogTimerTime(int new_value);
+	bool setOtgControlEnabled(bool new_value);
+	bool setMpptEnabled(bool new_value);
+	bool setThermalRegulationThreshold(int new_value);
+	bool setJeitaLowTemperatureChargeCurrentMultiplier(int new_value);
+	bool setJeitaHighTemperatureChargeCurrentMultiplier(int new_value);
+	bool setJeitaHighTempChargeVoltageOffset(int new_value);
+	bool setJeitaVt3Threshold(int new_value);
+	bool setJeitaVt2Threshold(int new_value);
+	bool setAdcEnabled(bool new_value);
+
+	// Any other field, with the arguments of the BQ25672 register accessors
+	bool setField(uint8_t reg, uint8_t byte_cnt, uint8_t bit_start, uint8_t bit_end, uint16_t new_data);
+
+private:
+	BQ25672RegisterImage image;
+	BQ25672RegisterImage set_mask;  // Bits of the fields that were set
+	uint8_t written_registers;
+	uint8_t bursts;
+	uint8_t span_first[BQ25672_IMAGE_BLOCK_COUNT];  // Written index range per block, 0xFF = none
+	uint8_t span_last[BQ25672_IMAGE_BLOCK_COUNT];
+
+	bool setScaled(uint8_t reg, uint8_t byte_cnt, uint8_t bit_start, uint8_t bit_end, uint16_t offset, uint8_t lsb, int new_value);
+	bool readSetRegisters(BQ25672 *charger, BQ25672RegisterImage *current);
+	bool writeDifferences(BQ25672 *charger, const BQ25672RegisterImage *target, const BQ25672RegisterImage *current);
+	bool verify(BQ25672 *charger, const BQ25672RegisterImage *target);
+	static bool differs(const BQ25672RegisterImage *a, const BQ25672RegisterImage *b, uint8_t index);
+	static bool isWordStart(uint8_t reg);
+};
+#endif /* BQ25672_CHARGE_PROFILE_H_ */
@@ -0,0 +1,76 @@
+/*
+  FILE:    BQ25672ConfigGuard.cpp
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Restores the BQ25672 configuration after a watchdog expiry
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#include "BQ25672ConfigGuard.h"
+
+#define DEFAULT_SENTINEL 0x01  // REG01 Charge Voltage Limit, MSB
+
+BQ25672ConfigGuard::BQ25672ConfigGuard(BQ25672 *charger):
+	_charger(charger), sentinel(DEFAULT_SENTINEL), replay_count(0), errors(0) {
+}
+
+bool BQ25672ConfigGuard::capture(){
+	if(!image.read(_charger)){
+		errors++;
+		return false;
+	}
+	return true;
+}
+
+void BQ25672ConfigGuard::setImage(const BQ25672RegisterImage *new_image){
+	image = *new_image;
+}
+
+BQ25672RegisterImage *BQ25672ConfigGuard::getImage(){
+	// Changes to the image are used by the next replay
+	return &image;
+}
+
+void BQ25672ConfigGuard::setSentinel(uint8_t reg){
+	if(BQ25672RegisterImage::indexOf(reg) >= 0) sentinel = reg;
+}
+
+bool BQ25672ConfigGuard::process(BQ25672EventSet flags){
+	if(!(flags & BQ25672_EVENT_BIT(BQ25672_EVENT_WATCHDOG))) return true;
+	return replay();
+}
+
+bool BQ25672ConfigGuard::checkSentinel(){
+	uint8_t value;
+	if(!_charger->readRegisters(sentinel, &value, 1)){
+		errors++;
+		return false;
+	}
+
+	uint8_t mask = ~BQ25672RegisterImage::getVolatileMask(sentinel);
+	if((value & mask) == (image.get(sentinel) & mask)) return true;
+	return replay();
+}
+
+bool BQ25672ConfigGuard::replay(){
+	if(!image.write(_charger)){
+		errors++;
+		return false;
+	}
+	replay_count++;
+	return true;
+}
+
+void BQ25672ConfigGuard::onWatchdog(uint8_t event, void *context){
+	(void) event;
+	static_cast<BQ25672ConfigGuard *>(context)->replay();
+}
+
+uint32_t BQ25672ConfigGuard::getReplayCount(){
+	return replay_count;
+}
+
+uint32_t BQ25672ConfigGuard::getErrorCount(){
+	return errors;
+}
@@ -0,0 +1,48 @@
+/*
+  FILE:    BQ25672ConfigGuard.h
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Restores the BQ25672 configuration after a watchdog expiry
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#ifndef BQ25672_CONFIG_GUARD_H_
+#define BQ25672_CONFIG_GUARD_H_
+
+#include "BQ25672.h"
+#include "BQ25672RegisterImage.h"
+
+// When the watchdog expires the charger resets its registers to the
+// defaults. The guard keeps the desired register image and replays it in
+// two burst writes as soon as the watchdog flag is seen, or when the
+// sentinel register no longer matches the image.
+class BQ25672ConfigGuard {
+public:
+	BQ25672ConfigGuard(BQ25672 *charger);
+
+	bool capture();  // Reads the current configuration as desired image
+	void setImage(const BQ25672RegisterImage *image);
+	BQ25672RegisterImage *getImage();
+
+	// The sentinel should hold a desired value that differs from its reset default
+	void setSentinel(uint8_t reg);
+
+	bool process(BQ25672EventSet flags);  // Replays on BQ25672_EVENT_WATCHDOG, returns false on a write error
+	bool checkSentinel();  // One register read, replays on a mismatch, returns false on a bus error
+	bool replay();
+
+	// Handler for BQ25672EventDispatcher::on(BQ25672_EVENT_WATCHDOG, ...), context = the guard
+	static void onWatchdog(uint8_t event, void *context);
+
+	uint32_t getReplayCount();
+	uint32_t getErrorCount();
+
+private:
+	BQ25672 *_charger;
+	BQ25672RegisterImage image;
+	uint8_t sentinel;
+	uint32_t replay_count;
+	uint32_t errors;
+};
+#endif /* BQ25672_CONFIG_GUARD_H_ */
@@ -0,0 +1,145 @@
+/*
+  FILE:    BQ25672CoulombCounter.cpp
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Integrates the BQ25672 battery current into charge in and out
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#include "BQ25672CoulombCounter.h"
+
+#define CHARGE_STATUS_DONE 7
+#define MA_MS_PER_UAH 3600
+
+BQ25672CoulombCounter::BQ25672CoulombCounter(uint32_t new_max_gap):
+	max_gap(new_max_gap), offset_x16(0) {
+	reset();
+}
+
+void BQ25672CoulombCounter::reset(){
+	// Keeps the learned current offset
+	charge_in = 0;
+	charge_out = 0;
+	charge_since_full = 0;
+	full_reference = false;
+	has_last = false;
+	last_current = 0;
+	last_timestamp = 0;
+	gap_count = 0;
+	gap_time = 0;
+}
+
+void BQ25672CoulombCounter::process(const BQ25672AdcSnapshot *adc, const BQ25672StatusSnapshot *status){
+	bool charge_done = status != NULL && BQ25672::getStatusField(status, BQ25672_STATUS_CHARGE_STATUS) == CHARGE_STATUS_DONE;
+
+	if(charge_done){
+		// The battery current is zero, what is measured is offset
+		offset_x16 += ((int32_t) adc->battery_current * 16 - offset_x16) / 16;
+		if(offset_x16 > BQ25672_COULOMB_MAX_OFFSET * 16) offset_x16 = BQ25672_COULOMB_MAX_OFFSET * 16;
+		if(offset_x16 < -BQ25672_COULOMB_MAX_OFFSET * 16) offset_x16 = -BQ25672_COULOMB_MAX_OFFSET * 16;
+	}
+
+	int32_t current = adc->battery_current - offset_x16 / 16;
+
+	if(has_last){
+		uint32_t delta_time = adc->timestamp - last_timestamp;
+		if(delta_time > max_gap){
+			// Still integrated, the trapezoid is the best estimate of the missed readouts
+			gap_count++;
+			gap_time += delta_time;
+		}
+
+		int64_t a = last_current;
+		int64_t b = current;
+		int64_t positive;
+		int64_t negative;
+
+		if(a >= 0 && b >= 0){
+			positive = (a + b) * delta_time;
+			negative = 0;
+		}
+		else if(a <= 0 && b <= 0){
+			positive = 0;
+			negative = -(a + b) * delta_time;
+		}
+		else{
+			// The current crosses zero, split the trapezoid into two triangles
+			int64_t high = a > 0 ? a : b;
+			int64_t low = a > 0 ? -b : -a;
+			positive = high * high * delta_time / (high + low);
+			negative = low * low * delta_time / (high + low);
+		}
+
+		// Areas above are twice the charge
+		charge_in += positive / 2;
+		charge_out += negative / 2;
+		charge_since_full += (positive - negative) / 2;
+	}
+
+	if(charge_done){
+		charge_since_full = 0;
+		full_reference = true;
+	}
+
+	has_last = true;
+	last_current = current;
+	last_timestamp = adc->timestamp;
+}
+
+int32_t BQ25672CoulombCounter::getChargeIn(){
+	return toMicroAh(charge_in);
+}
+
+int32_t BQ25672CoulombCounter::getChargeOut(){
+	return toMicroAh(charge_out);
+}
+
+int32_t BQ25672CoulombCounter::getNetCharge(){
+	return toMicroAh(charge_in - charge_out);
+}
+
+float BQ25672CoulombCounter::getChargeInMah(){
+	return charge_in / (float)(MA_MS_PER_UAH * 1000UL);
+}
+
+float BQ25672CoulombCounter::getChargeOutMah(){
+	return charge_out / (float)(MA_MS_PER_UAH * 1000UL);
+}
+
+bool BQ25672CoulombCounter::isFullReferenceValid(){
+	return full_reference;
+}
+
+int32_t BQ25672CoulombCounter::getChargeSinceFull(){
+	return toMicroAh(charge_since_full);
+}
+
+int16_t BQ25672CoulombCounter::getCurrentOffset(){
+	return offset_x16 / 16;
+}
+
+void BQ25672CoulombCounter::setCurrentOffset(int16_t offset){
+	// E.g. to restore a learned offset after a restart
+	offset_x16 = (int32_t) offset * 16;
+}
+
+uint32_t BQ25672CoulombCounter::getGapCount(){
+	return gap_count;
+}
+
+uint32_t BQ25672CoulombCounter::getGapTime(){
+	return gap_time;
+}
+
+int16_t BQ25672CoulombCounter::getLastCurrent(){
+	return last_current;
+}
+
+uint32_t BQ25672CoulombCounter::getLastTimestamp(){
+	return last_timestamp;
+}
+
+int32_t BQ25672CoulombCounter::toMicroAh(int64_t charge){
+	return charge / MA_MS_PER_UAH;
+}
@@ -0,0 +1,64 @@
+/*
+  FILE:    BQ25672CoulombCounter.h
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Integrates the BQ25672 battery current into charge in and out
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#ifndef BQ25672_COULOMB_COUNTER_H_
+#define BQ25672_COULOMB_COUNTER_H_
+
+#include "BQ25672.h"
+
+#define BQ25672_COULOMB_MAX_OFFSET 20  // mA, limit of the learned IBAT offset
+
+// Trapezoidal integration of IBAT between snapshot timestamps, so missed
+// readouts do not lose charge. While the charge status is "Charge done" the
+// battery current is known to be zero: the reading is learned as IBAT offset
+// and the charge since full is reset.
+class BQ25672CoulombCounter {
+public:
+	BQ25672CoulombCounter(uint32_t max_gap = 5000);  // ms, longer intervals are counted as gaps
+
+	void reset();
+	void process(const BQ25672AdcSnapshot *adc, const BQ25672StatusSnapshot *status = NULL);
+
+	int32_t getChargeIn();  // uAh
+	int32_t getChargeOut();  // uAh
+	int32_t getNetCharge();  // uAh, in - out
+	float getChargeInMah();
+	float getChargeOutMah();
+
+	bool isFullReferenceValid();
+	int32_t getChargeSinceFull();  // uAh, negative after discharging, valid after a charge done
+
+	int16_t getCurrentOffset();  // mA
+	void setCurrentOffset(int16_t offset);
+	uint32_t getGapCount();
+	uint32_t getGapTime();  // ms
+
+	int16_t getLastCurrent();  // mA, offset corrected
+	uint32_t getLastTimestamp();
+
+private:
+	uint32_t max_gap;
+
+	// Charge in mA * ms
+	int64_t charge_in;
+	int64_t charge_out;
+	int64_t charge_since_full;
+	bool full_reference;
+
+	bool has_last;
+	int32_t last_current;
+	uint32_t last_timestamp;
+	int32_t offset_x16;  // mA * 16
+
+	uint32_t gap_count;
+	uint32_t gap_time;
+
+	static int32_t toMicroAh(int64_t charge);
+};
+#endif /* BQ25672_COULOMB_COUNTER_H_ */
@@ -0,0 +1,110 @@
+/*
+  FILE:    BQ25672CycleTracker.cpp
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Per charge cycle statistics from the BQ25672 snapshot streams
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#include "BQ25672CycleTracker.h"
+
+#define CHARGE_STATUS_DONE 7
+#define MA_MS_PER_UAH 3600
+#define TIMER_FAULT_BITS 0x0E000000ULL  // Pre-charge, trickle and fast charge timer expired
+
+BQ25672CycleTracker::BQ25672CycleTracker(){
+	reset();
+}
+
+void BQ25672CycleTracker::reset(){
+	memset(history, 0, sizeof(history));
+	memset(&current, 0, sizeof(current));
+	cycle_count = 0;
+	charging = false;
+	has_last = false;
+	last_charge_status = 0;
+	last_timestamp = 0;
+	last_current = 0;
+	charge = 0;
+}
+
+void BQ25672CycleTracker::process(const BQ25672AdcSnapshot *adc, const BQ25672StatusSnapshot *status){
+	uint8_t charge_status = BQ25672::getStatusField(status, BQ25672_STATUS_CHARGE_STATUS);
+	uint64_t status_bits = BQ25672::getStatusBits(status);
+	int32_t battery_current = adc->battery_current > 0 ? adc->battery_current : 0;
+	uint32_t now = adc->timestamp;
+
+	if(charging && has_last){
+		// The interval belongs to the phase of the previous snapshot
+		uint32_t delta_time = now - last_timestamp;
+		if(last_charge_status >= 1 && last_charge_status <= BQ25672_CYCLE_PHASES){
+			current.phase_time[last_charge_status - 1] += delta_time;
+		}
+		current.duration += delta_time;
+
+		charge += (int64_t)(last_current + battery_current) * delta_time;
+		current.charge = charge / (2 * MA_MS_PER_UAH);
+	}
+
+	bool in_phase = charge_status >= 1 && charge_status <= BQ25672_CYCLE_PHASES;
+	if(!charging && in_phase){
+		memset(&current, 0, sizeof(current));
+		current.start = now;
+		current.peak_die_temperature = adc->die_temperature;
+		charge = 0;
+		charging = true;
+	}
+
+	if(charging){
+		current.faults |= status_bits & BQ25672_CYCLE_FAULT_BITS;
+		if(adc->die_temperature > current.peak_die_temperature) current.peak_die_temperature = adc->die_temperature;
+
+		if(!in_phase){
+			if(charge_status == CHARGE_STATUS_DONE){
+				finish(BQ25672_CYCLE_END_DONE);
+			}
+			else if(!(status_bits & ((uint64_t) 1 << BQ25672_STATUS_POWER_GOOD))){
+				finish(BQ25672_CYCLE_END_INPUT_REMOVED);
+			}
+			else if(current.faults & TIMER_FAULT_BITS){
+				finish(BQ25672_CYCLE_END_TIMER);
+			}
+			else if(current.faults){
+				finish(BQ25672_CYCLE_END_FAULT);
+			}
+			else{
+				finish(BQ25672_CYCLE_END_STOPPED);
+			}
+		}
+	}
+
+	has_last = true;
+	last_charge_status = charge_status;
+	last_timestamp = now;
+	last_current = battery_current;
+}
+
+bool BQ25672CycleTracker::isCharging(){
+	return charging;
+}
+
+const BQ25672CycleSummary *BQ25672CycleTracker::getCurrentCycle(){
+	return charging ? &current : NULL;
+}
+
+uint32_t BQ25672CycleTracker::getCycleCount(){
+	return cycle_count;
+}
+
+const BQ25672CycleSummary *BQ25672CycleTracker::getCycle(uint8_t index){
+	if(index >= BQ25672_CYCLE_HISTORY || index >= cycle_count) return NULL;
+	return &history[(cycle_count - 1 - index) % BQ25672_CYCLE_HISTORY];
+}
+
+void BQ25672CycleTracker::finish(uint8_t end_reason){
+	current.end_reason = end_reason;
+	history[cycle_count % BQ25672_CYCLE_HISTORY] = current;
+	cycle_count++;
+	charging = false;
+}
@@ -0,0 +1,72 @@
+/*
+  FILE:    BQ25672CycleTracker.h
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Per charge cycle statistics from the BQ25672 snapshot streams
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#ifndef BQ25672_CYCLE_TRACKER_H_
+#define BQ25672_CYCLE_TRACKER_H_
+
+#include "BQ25672.h"
+
+// Summaries of the last completed cycles that are kept
+#ifndef BQ25672_CYCLE_HISTORY
+#define BQ25672_CYCLE_HISTORY 4
+#endif
+
+// Charge status 1..6: trickle, pre-charge, fast (CC), taper (CV), reserved, top-off
+#define BQ25672_CYCLE_PHASES 6
+
+#define BQ25672_CYCLE_END_NONE 0  // Still charging
+#define BQ25672_CYCLE_END_DONE 1  // Charge done
+#define BQ25672_CYCLE_END_INPUT_REMOVED 2  // Power good was lost
+#define BQ25672_CYCLE_END_TIMER 3  // A safety timer expired
+#define BQ25672_CYCLE_END_FAULT 4  // Stopped with a fault or TS hot/cold
+#define BQ25672_CYCLE_END_STOPPED 5  // Stopped otherwise, e.g. charging disabled
+
+// Status bits counted as fault: safety timers, TS hot and cold, and REG20/REG21 except IBAT regulation
+#define BQ25672_CYCLE_FAULT_BITS 0x00F47F090E000000ULL
+
+struct BQ25672CycleSummary {
+	uint32_t start;  // Timestamp of the first snapshot
+	uint32_t duration;  // ms
+	uint32_t phase_time[BQ25672_CYCLE_PHASES];  // ms, index = charge status - 1
+	int32_t charge;  // uAh into the battery
+	int16_t peak_die_temperature;  // 0.5 C
+	uint8_t end_reason;
+	uint64_t faults;  // Status bits of BQ25672_CYCLE_FAULT_BITS seen during the cycle
+};
+
+// Follows the charge status of the status snapshots: a cycle starts when the
+// status turns to a charging phase and ends at charge done or when charging
+// stops. No registers are read, pass the snapshots that are taken anyway.
+class BQ25672CycleTracker {
+public:
+	BQ25672CycleTracker();
+
+	void reset();
+	void process(const BQ25672AdcSnapshot *adc, const BQ25672StatusSnapshot *status);
+
+	bool isCharging();
+	const BQ25672CycleSummary *getCurrentCycle();  // NULL when not charging
+	uint32_t getCycleCount();  // Completed cycles
+	const BQ25672CycleSummary *getCycle(uint8_t index);  // 0 = last completed, NULL if not available
+
+private:
+	BQ25672CycleSummary history[BQ25672_CYCLE_HISTORY];
+	BQ25672CycleSummary current;
+	uint32_t cycle_count;
+	bool charging;
+
+	bool has_last;
+	uint8_t last_charge_status;
+	uint32_t last_timestamp;
+	int32_t last_current;
+	int64_t charge;  // mA * ms of the current cycle
+
+	void finish(uint8_t end_reason);
+};
+#endif /* BQ25672_CYCLE_TRACKER_H_ */
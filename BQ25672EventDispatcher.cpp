@@ -0,0 +1,50 @@
+/*
+  FILE:    BQ25672EventDispatcher.cpp
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Calls registered handlers for the flags read by BQ25672::readFlags
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#include "BQ25672EventDispatcher.h"
+
+BQ25672EventDispatcher::BQ25672EventDispatcher():
+	handled_events(0) {
+	for(int i = 0; i < BQ25672_EVENT_COUNT; i++){
+		handlers[i] = NULL;
+		contexts[i] = NULL;
+	}
+}
+
+bool BQ25672EventDispatcher::on(uint8_t event, BQ25672EventHandler handler, void *context){
+	if(event >= BQ25672_EVENT_COUNT || handler == NULL) return false;
+
+	handlers[event] = handler;
+	contexts[event] = context;
+	handled_events |= BQ25672_EVENT_BIT(event);
+	return true;
+}
+
+void BQ25672EventDispatcher::off(uint8_t event){
+	if(event >= BQ25672_EVENT_COUNT) return;
+
+	handled_events &= ~BQ25672_EVENT_BIT(event);
+	handlers[event] = NULL;
+	contexts[event] = NULL;
+}
+
+BQ25672EventSet BQ25672EventDispatcher::getHandledEvents(){
+	return handled_events;
+}
+
+void BQ25672EventDispatcher::dispatch(BQ25672EventSet flags){
+	// Only visits the set bits that have a handler
+	BQ25672EventSet pending = flags & handled_events;
+
+	while(pending){
+		uint8_t event = __builtin_ctzll(pending);
+		pending &= pending - 1;
+		handlers[event](event, contexts[event]);
+	}
+}
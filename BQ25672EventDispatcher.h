@@ -0,0 +1,32 @@
+/*
+  FILE:    BQ25672EventDispatcher.h
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Calls registered handlers for the flags read by BQ25672::readFlags
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#ifndef BQ25672_EVENT_DISPATCHER_H_
+#define BQ25672_EVENT_DISPATCHER_H_
+
+#include "BQ25672.h"
+
+typedef void (*BQ25672EventHandler)(uint8_t event, void *context);
+
+class BQ25672EventDispatcher {
+public:
+	BQ25672EventDispatcher();
+
+	bool on(uint8_t event, BQ25672EventHandler handler, void *context = NULL);
+	void off(uint8_t event);
+	BQ25672EventSet getHandledEvents();
+
+	void dispatch(BQ25672EventSet flags);
+
+private:
+	BQ25672EventHandler handlers[BQ25672_EVENT_COUNT];
+	void *contexts[BQ25672_EVENT_COUNT];
+	BQ25672EventSet handled_events;
+};
+#endif /* BQ25672_EVENT_DISPATCHER_H_ */
@@ -0,0 +1,172 @@
+/*
+  FILE:    BQ25672EventLog.cpp
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Compact binary log of BQ25672 events
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#include "BQ25672EventLog.h"
+
+static uint8_t encode_sync(uint8_t *data, uint32_t time){
+	data[0] = BQ25672_LOG_ID_SYNC;
+	for(int i = 0; i < 4; i++){
+		data[1 + i] = (time >> (8 * i)) & 0xFF;
+	}
+	return 5;
+}
+
+BQ25672EventLog::BQ25672EventLog():
+	_buffer(NULL), _size(0), head(0), tail(0), used(0), base_time(0),
+	_append(NULL), _context(NULL),
+	last_time(0), last_charge_status(0xFF), record_count(0), dropped_count(0) {
+}
+
+bool BQ25672EventLog::begin(uint8_t *buffer, uint16_t size, uint32_t now){
+	if(buffer == NULL || size < BQ25672_LOG_MAX_RECORD_SIZE) return false;
+
+	_buffer = buffer;
+	_size = size;
+	_append = NULL;
+	head = 0;
+	tail = 0;
+	used = 0;
+	base_time = now;
+	last_time = now;
+	last_charge_status = 0xFF;
+	record_count = 0;
+	dropped_count = 0;
+	return true;
+}
+
+bool BQ25672EventLog::begin(BQ25672LogAppendFunction append, void *context, uint32_t now){
+	if(append == NULL) return false;
+
+	_buffer = NULL;
+	_append = append;
+	_context = context;
+	last_time = now;
+	last_charge_status = 0xFF;
+	record_count = 0;
+	dropped_count = 0;
+
+	// Every append session starts with the absolute time
+	uint8_t data[5];
+	uint8_t length = encode_sync(data, now);
+	return _append(data, length, _context);
+}
+
+bool BQ25672EventLog::log(uint8_t id, uint32_t timestamp){
+	uint32_t delta = timestamp - last_time;
+	if(delta & 0x80000000UL){
+		// Older than the previous record, log it at the time of the previous record
+		delta = 0;
+	}
+	else{
+		last_time = timestamp;
+	}
+
+	uint8_t data[BQ25672_LOG_MAX_RECORD_SIZE];
+	uint8_t length = 0;
+	data[length++] = id;
+	do{
+		uint8_t byte = delta & 0x7F;
+		delta >>= 7;
+		data[length++] = delta ? (byte | 0x80) : byte;
+	} while(delta);
+
+	return write(data, length);
+}
+
+uint8_t BQ25672EventLog::logFlags(BQ25672EventSet flags, uint32_t timestamp){
+	// Returns the number of logged flags
+	uint8_t count = 0;
+
+	while(flags){
+		uint8_t event = __builtin_ctzll(flags);
+		flags &= flags - 1;
+		count += log(event, timestamp);
+	}
+	return count;
+}
+
+bool BQ25672EventLog::logStatus(const BQ25672StatusSnapshot *snapshot){
+	// Charge status is bits 7:5 of register 0x1C
+	uint8_t charge_status = snapshot->status[1] >> 5;
+	if(charge_status == last_charge_status) return false;
+
+	last_charge_status = charge_status;
+	return log(BQ25672_LOG_ID_CHARGE_STATUS + charge_status, snapshot->timestamp);
+}
+
+uint16_t BQ25672EventLog::read(uint8_t *out, uint16_t size){
+	// Returns the number of bytes copied, 0 if out is too small
+	if(_buffer == NULL || size < used + 5) return 0;
+
+	uint16_t length = encode_sync(out, base_time);
+	uint16_t pos = tail;
+	for(int i = 0; i < used; i++){
+		out[length++] = _buffer[pos];
+		pos = pos + 1 == _size ? 0 : pos + 1;
+	}
+	return length;
+}
+
+uint16_t BQ25672EventLog::getUsedBytes(){
+	return used;
+}
+
+uint32_t BQ25672EventLog::getRecordCount(){
+	return record_count;
+}
+
+uint32_t BQ25672EventLog::getDroppedCount(){
+	// Ring buffer mode: records dropped to make room, append mode: failed appends
+	return dropped_count;
+}
+
+bool BQ25672EventLog::write(const uint8_t *data, uint8_t length){
+	if(_append != NULL){
+		if(!_append(data, length, _context)){
+			dropped_count++;
+			return false;
+		}
+		record_count++;
+		return true;
+	}
+
+	if(_buffer == NULL) return false;
+
+	while(_size - used < length){
+		dropOldest();
+	}
+
+	for(int i = 0; i < length; i++){
+		_buffer[head] = data[i];
+		head = head + 1 == _size ? 0 : head + 1;
+	}
+	used += length;
+	record_count++;
+	return true;
+}
+
+void BQ25672EventLog::dropOldest(){
+	// Skips the id and decodes the delta, so the time of the next record stays known
+	tail = tail + 1 == _size ? 0 : tail + 1;
+	used--;
+
+	uint32_t delta = 0;
+	uint8_t shift = 0;
+	uint8_t byte;
+	do{
+		byte = _buffer[tail];
+		tail = tail + 1 == _size ? 0 : tail + 1;
+		used--;
+		delta |= (uint32_t)(byte & 0x7F) << shift;
+		shift += 7;
+	} while(byte & 0x80);
+
+	base_time += delta;
+	dropped_count++;
+}
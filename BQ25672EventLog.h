@@ -0,0 +1,64 @@
+/*
+  FILE:    BQ25672EventLog.h
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Compact binary log of BQ25672 events
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#ifndef BQ25672_EVENT_LOG_H_
+#define BQ25672_EVENT_LOG_H_
+
+#include "BQ25672.h"
+
+// Record: 1 byte id followed by the time since the previous record in ms as
+// an unsigned LEB128 varint. A sync record carries an absolute time instead.
+#define BQ25672_LOG_ID_CHARGE_STATUS 0x40  // 0x40 + new charge status (0..7)
+#define BQ25672_LOG_ID_SYNC 0xFE  // Followed by the absolute time in ms, 4 bytes little endian
+#define BQ25672_LOG_ID_ERASED 0xFF  // Unwritten flash, end of log
+
+#define BQ25672_LOG_MAX_RECORD_SIZE 6
+
+// Writes data to e.g. a flash region, returns false when the region is full
+typedef bool (*BQ25672LogAppendFunction)(const uint8_t *data, uint8_t length, void *context);
+
+class BQ25672EventLog {
+public:
+	BQ25672EventLog();
+
+	// Ring buffer mode, the oldest records are dropped when the buffer is full
+	bool begin(uint8_t *buffer, uint16_t size, uint32_t now);
+	// Append mode, every record is passed to the append function
+	bool begin(BQ25672LogAppendFunction append, void *context, uint32_t now);
+
+	bool log(uint8_t id, uint32_t timestamp);
+	uint8_t logFlags(BQ25672EventSet flags, uint32_t timestamp);
+	bool logStatus(const BQ25672StatusSnapshot *snapshot);  // Logs charge status transitions
+
+	// Ring buffer mode: copies the log, starting with a sync record, to out
+	uint16_t read(uint8_t *out, uint16_t size);
+	uint16_t getUsedBytes();
+	uint32_t getRecordCount();
+	uint32_t getDroppedCount();
+
+private:
+	uint8_t *_buffer;
+	uint16_t _size;
+	uint16_t head;
+	uint16_t tail;
+	uint16_t used;
+	uint32_t base_time;  // Time of the record before the oldest record in the buffer
+
+	BQ25672LogAppendFunction _append;
+	void *_context;
+
+	uint32_t last_time;
+	uint8_t last_charge_status;
+	uint32_t record_count;
+	uint32_t dropped_count;
+
+	bool write(const uint8_t *data, uint8_t length);
+	void dropOldest();
+};
+#endif /* BQ25672_EVENT_LOG_H_ */
@@ -0,0 +1,133 @@
+/*
+  FILE:    BQ25672EventQueue.cpp
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Lock-free queue between the BQ25672 INT pin and the main loop
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#include "BQ25672EventQueue.h"
+
+// Head and tail run freely, the difference is the fill level
+#define INTERRUPT_INDEX(i) ((i) & (BQ25672_INTERRUPT_QUEUE_SIZE - 1))
+#define EVENT_INDEX(i) ((i) & (BQ25672_EVENT_QUEUE_SIZE - 1))
+
+BQ25672EventQueue::BQ25672EventQueue():
+	interrupt_head(0), interrupt_tail(0), interrupt_overflows(0),
+	event_head(0), event_tail(0), event_overflows(0), read_errors(0) {
+}
+
+void BQ25672_ISR_ATTR BQ25672EventQueue::pushInterrupt(uint32_t timestamp){
+	uint8_t head = interrupt_head;
+
+	if((uint8_t)(head - interrupt_tail) >= BQ25672_INTERRUPT_QUEUE_SIZE){
+		interrupt_overflows = interrupt_overflows + 1;
+		return;
+	}
+
+	interrupt_times[INTERRUPT_INDEX(head)] = timestamp;
+	BQ25672_MEMORY_BARRIER();
+	interrupt_head = head + 1;
+}
+
+uint8_t BQ25672EventQueue::getPendingInterrupts(){
+	return interrupt_head - interrupt_tail;
+}
+
+uint8_t BQ25672EventQueue::process(BQ25672 *charger){
+	// Handles the queued interrupts with one flag readout, the flags clear on read so
+	// every later read would be empty. Records carry the first and last interrupt time.
+	// Returns the number of queued records
+
+	uint8_t tail = interrupt_tail;
+	uint8_t head = interrupt_head;
+	if(tail == head) return 0;
+
+	BQ25672_MEMORY_BARRIER();
+	uint32_t first_time = interrupt_times[INTERRUPT_INDEX(tail)];
+	uint32_t last_time = interrupt_times[INTERRUPT_INDEX(head - 1)];
+	uint8_t interrupt_count = head - tail;
+
+	// The flags stay latched when the read fails, keep the interrupts for the next call
+	if(!charger->readFlags()){
+		read_errors++;
+		return 0;
+	}
+	BQ25672_MEMORY_BARRIER();
+	interrupt_tail = head;
+
+	BQ25672StatusSnapshot snapshot;
+	memset(&snapshot, 0, sizeof(snapshot));
+	if(!charger->readStatusSnapshot(&snapshot)){
+		read_errors++;
+	}
+
+	uint8_t added = 0;
+	BQ25672EventSet pending = charger->getFlags();
+	while(pending){
+		uint8_t event = __builtin_ctzll(pending);
+		pending &= pending - 1;
+		added += pushEvent(event, first_time, &snapshot, last_time, interrupt_count);
+	}
+	return added;
+}
+
+bool BQ25672EventQueue::pushEvent(uint8_t event, uint32_t timestamp, const BQ25672StatusSnapshot *snapshot, uint32_t last_timestamp, uint8_t interrupt_count){
+	// Drops the new record when the queue is full, so the queued order stays intact
+	uint8_t head = event_head;
+
+	if((uint8_t)(head - event_tail) >= BQ25672_EVENT_QUEUE_SIZE){
+		event_overflows++;
+		return false;
+	}
+
+	BQ25672EventRecord *record = &events[EVENT_INDEX(head)];
+	record->timestamp = timestamp;
+	record->last_timestamp = interrupt_count > 1 ? last_timestamp : timestamp;
+	record->interrupt_count = interrupt_count;
+	record->event = event;
+	memcpy(record->status, snapshot->status, BQ25672_STATUS_REGISTER_COUNT);
+
+	BQ25672_MEMORY_BARRIER();
+	event_head = head + 1;
+	return true;
+}
+
+uint8_t BQ25672EventQueue::available(){
+	return event_head - event_tail;
+}
+
+bool BQ25672EventQueue::popEvent(BQ25672EventRecord *record){
+	return popEvents(record, 1) == 1;
+}
+
+uint8_t BQ25672EventQueue::popEvents(BQ25672EventRecord *records, uint8_t max_count){
+	// Returns the number of records copied, oldest first
+
+	uint8_t tail = event_tail;
+	uint8_t count = event_head - tail;
+	BQ25672_MEMORY_BARRIER();
+
+	if(count > max_count) count = max_count;
+
+	for(int i = 0; i < count; i++){
+		records[i] = events[EVENT_INDEX(tail + i)];
+	}
+
+	BQ25672_MEMORY_BARRIER();
+	event_tail = tail + count;
+	return count;
+}
+
+uint32_t BQ25672EventQueue::getInterruptOverflowCount(){
+	return interrupt_overflows;
+}
+
+uint32_t BQ25672EventQueue::getEventOverflowCount(){
+	return event_overflows;
+}
+
+uint32_t BQ25672EventQueue::getReadErrorCount(){
+	return read_errors;
+}
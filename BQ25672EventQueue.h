@@ -0,0 +1,79 @@
+/*
+  FILE:    BQ25672EventQueue.h
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Lock-free queue between the BQ25672 INT pin and the main loop
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#ifndef BQ25672_EVENT_QUEUE_H_
+#define BQ25672_EVENT_QUEUE_H_
+
+#include "BQ25672.h"
+
+// Both sizes must be a power of 2 and at most 128
+#ifndef BQ25672_INTERRUPT_QUEUE_SIZE
+#define BQ25672_INTERRUPT_QUEUE_SIZE 16
+#endif
+#ifndef BQ25672_EVENT_QUEUE_SIZE
+#define BQ25672_EVENT_QUEUE_SIZE 32
+#endif
+
+#if defined(ESP32) || defined(ESP8266)
+#define BQ25672_ISR_ATTR IRAM_ATTR
+#else
+#define BQ25672_ISR_ATTR
+#endif
+
+#if defined(__AVR__)
+#define BQ25672_MEMORY_BARRIER() asm volatile("" ::: "memory")
+#else
+#define BQ25672_MEMORY_BARRIER() __sync_synchronize()
+#endif
+
+// The flags clear on read, so the interrupts handled by one process() call
+// share one flag readout: their order within the batch is lost. A record
+// tells how many interrupts were merged and when the first and the last came.
+struct BQ25672EventRecord {
+	uint32_t timestamp;  // Of the first interrupt handled by the same process() call
+	uint32_t last_timestamp;  // Of the last one, equal to timestamp for a single interrupt
+	uint8_t interrupt_count;  // Interrupts merged into the flag readout
+	uint8_t event;  // BQ25672Event
+	uint8_t status[BQ25672_STATUS_REGISTER_COUNT];  // Status registers 0x1B..0x21 right after the flag readout
+};
+
+// Single producer, single consumer: pushInterrupt() is called from one ISR,
+// process() and popEvents() from one task or the main loop.
+class BQ25672EventQueue {
+public:
+	BQ25672EventQueue();
+
+	void pushInterrupt(uint32_t timestamp);  // ISR safe
+	uint8_t getPendingInterrupts();
+
+	uint8_t process(BQ25672 *charger);  // One flag and status readout for all queued interrupts
+
+	uint8_t available();
+	bool popEvent(BQ25672EventRecord *record);
+	uint8_t popEvents(BQ25672EventRecord *records, uint8_t max_count);
+
+	bool pushEvent(uint8_t event, uint32_t timestamp, const BQ25672StatusSnapshot *snapshot, uint32_t last_timestamp = 0, uint8_t interrupt_count = 1);
+
+	uint32_t getInterruptOverflowCount();
+	uint32_t getEventOverflowCount();
+	uint32_t getReadErrorCount();
+
+private:
+	uint32_t interrupt_times[BQ25672_INTERRUPT_QUEUE_SIZE];
+	volatile uint8_t interrupt_head;
+	volatile uint8_t interrupt_tail;
+	volatile uint32_t interrupt_overflows;
+
+	BQ25672EventRecord events[BQ25672_EVENT_QUEUE_SIZE];
+	volatile uint8_t event_head;
+	volatile uint8_t event_tail;
+	uint32_t event_overflows;
+	uint32_t read_errors;
+};
+#endif /* BQ25672_EVENT_QUEUE_H_ */
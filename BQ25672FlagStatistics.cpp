@@ -0,0 +1,185 @@
+/*
+  FILE:    BQ25672FlagStatistics.cpp
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Occurrence counters and rates of the BQ25672 flags
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#include "BQ25672FlagStatistics.h"
+
+#define FLAG_BITS_MASK ((BQ25672EventSet) 0xFFFFFFFFFFFFULL)
+
+static void put_u16(uint8_t *buffer, uint16_t value){
+	buffer[0] = value & 0xFF;
+	buffer[1] = value >> 8;
+}
+
+static void put_u32(uint8_t *buffer, uint32_t value){
+	put_u16(buffer, value & 0xFFFF);
+	put_u16(buffer + 2, value >> 16);
+}
+
+BQ25672FlagStatistics::BQ25672FlagStatistics(uint32_t new_window_time):
+	window_time(new_window_time > 0 ? new_window_time : 1) {
+	reset();
+}
+
+void BQ25672FlagStatistics::reset(){
+	window_start = 0;
+	elapsed_windows = 0;
+	history_head = 0;
+	seen = 0;
+	memset(planes, 0, sizeof(planes));
+	memset(totals, 0, sizeof(totals));
+	memset(last_seen, 0, sizeof(last_seen));
+	memset(history, 0, sizeof(history));
+}
+
+void BQ25672FlagStatistics::record(BQ25672EventSet flags, uint32_t now){
+	update(now);
+
+	flags &= FLAG_BITS_MASK;
+	if(!flags) return;
+
+	// A counter that is already at its maximum would wrap, close the window early
+	uint64_t full = planes[0];
+	for(int n = 1; n < BQ25672_STATISTICS_PLANES; n++){
+		full &= planes[n];
+	}
+	if(flags & full){
+		closeWindow();
+	}
+
+	// Adds one to the counter of every set flag at once, ripple carry through the planes
+	uint64_t carry = flags;
+	for(int n = 0; n < BQ25672_STATISTICS_PLANES && carry; n++){
+		uint64_t next_carry = planes[n] & carry;
+		planes[n] ^= carry;
+		carry = next_carry;
+	}
+
+	seen |= flags;
+
+	BQ25672EventSet pending = flags;
+	while(pending){
+		uint8_t event = __builtin_ctzll(pending);
+		pending &= pending - 1;
+		last_seen[event] = now;
+	}
+}
+
+void BQ25672FlagStatistics::update(uint32_t now){
+	if(now - window_start < window_time) return;
+
+	if(now - window_start >= (uint32_t)(BQ25672_STATISTICS_WINDOWS + 1) * window_time){
+		// Every window in the history has passed without a call
+		closeWindow();
+		memset(history, 0, sizeof(history));
+		window_start = now;
+		elapsed_windows = BQ25672_STATISTICS_WINDOWS;
+		return;
+	}
+
+	while(now - window_start >= window_time){
+		closeWindow();
+		window_start += window_time;
+		if(elapsed_windows < BQ25672_STATISTICS_WINDOWS) elapsed_windows++;
+	}
+}
+
+uint32_t BQ25672FlagStatistics::getCount(uint8_t event){
+	if(event >= BQ25672_EVENT_COUNT) return 0;
+
+	uint32_t count = totals[event] + planeCount(event);
+	return count < totals[event] ? UINT32_MAX : count;
+}
+
+uint32_t BQ25672FlagStatistics::getLastSeen(uint8_t event){
+	// Returns value in: ms, 0 if never seen
+	if(event >= BQ25672_EVENT_COUNT) return 0;
+	return last_seen[event];
+}
+
+uint32_t BQ25672FlagStatistics::getWindowCount(uint8_t event){
+	// Occurrences in the stored windows plus the running window
+	if(event >= BQ25672_EVENT_COUNT) return 0;
+
+	uint32_t count = planeCount(event);
+	for(int w = 0; w < BQ25672_STATISTICS_WINDOWS; w++){
+		count += history[w][event];
+	}
+	return count;
+}
+
+uint32_t BQ25672FlagStatistics::getRatePerHour(uint8_t event, uint32_t now){
+	update(now);
+
+	// Only the windows that have passed since reset() count, otherwise the rate starts far too low
+	uint64_t span = (uint64_t) elapsed_windows * window_time + (now - window_start);
+	if(span == 0) return 0;
+	return (uint64_t) getWindowCount(event) * 3600000UL / span;
+}
+
+BQ25672EventSet BQ25672FlagStatistics::getSeenEvents(){
+	return seen;
+}
+
+uint16_t BQ25672FlagStatistics::exportRecord(uint8_t *buffer, uint16_t size, uint32_t now){
+	// Returns the number of bytes written, 0 if the buffer is too small
+	update(now);
+
+	uint16_t length = 11 + 10 * __builtin_popcountll(seen);
+	if(size < length) return 0;
+
+	buffer[0] = BQ25672_STATISTICS_RECORD_VERSION;
+	put_u32(buffer + 1, now);
+	for(int i = 0; i < 6; i++){
+		buffer[5 + i] = (seen >> (8 * i)) & 0xFF;
+	}
+
+	uint16_t pos = 11;
+	BQ25672EventSet pending = seen;
+	while(pending){
+		uint8_t event = __builtin_ctzll(pending);
+		pending &= pending - 1;
+
+		uint32_t window_count = getWindowCount(event);
+		put_u32(buffer + pos, getCount(event));
+		put_u32(buffer + pos + 4, last_seen[event]);
+		put_u16(buffer + pos + 8, window_count > UINT16_MAX ? UINT16_MAX : window_count);
+		pos += 10;
+	}
+	return length;
+}
+
+uint16_t BQ25672FlagStatistics::planeCount(uint8_t event){
+	uint16_t count = 0;
+	for(int n = 0; n < BQ25672_STATISTICS_PLANES; n++){
+		count |= ((planes[n] >> event) & 1) << n;
+	}
+	return count;
+}
+
+void BQ25672FlagStatistics::closeWindow(){
+	// Moves the running window into the history and the totals
+	history_head = (history_head + 1) % BQ25672_STATISTICS_WINDOWS;
+	memset(history[history_head], 0, sizeof(history[history_head]));
+
+	uint64_t active = 0;
+	for(int n = 0; n < BQ25672_STATISTICS_PLANES; n++){
+		active |= planes[n];
+	}
+
+	while(active){
+		uint8_t event = __builtin_ctzll(active);
+		active &= active - 1;
+
+		uint16_t count = planeCount(event);
+		history[history_head][event] = count;
+		totals[event] = (totals[event] + count < totals[event]) ? UINT32_MAX : totals[event] + count;
+	}
+
+	memset(planes, 0, sizeof(planes));
+}
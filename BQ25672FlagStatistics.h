@@ -0,0 +1,62 @@
+/*
+  FILE:    BQ25672FlagStatistics.h
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Occurrence counters and rates of the BQ25672 flags
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#ifndef BQ25672_FLAG_STATISTICS_H_
+#define BQ25672_FLAG_STATISTICS_H_
+
+#include "BQ25672.h"
+
+// The rate is taken over the completed windows since reset(), at most
+// BQ25672_STATISTICS_WINDOWS, plus the running one
+#ifndef BQ25672_STATISTICS_WINDOWS
+#define BQ25672_STATISTICS_WINDOWS 4
+#endif
+
+// Bits per flag of the bit-sliced counter of the running window
+#define BQ25672_STATISTICS_PLANES 16
+
+#define BQ25672_STATISTICS_RECORD_VERSION 1
+#define BQ25672_STATISTICS_RECORD_MAX_SIZE (11 + 10 * BQ25672_EVENT_COUNT)
+
+class BQ25672FlagStatistics {
+public:
+	BQ25672FlagStatistics(uint32_t window_time = 60000);  // Window length in ms
+
+	void reset();
+	void record(BQ25672EventSet flags, uint32_t now);  // Called by BQ25672::readFlags() when attached
+	void update(uint32_t now);
+
+	uint32_t getCount(uint8_t event);
+	uint32_t getLastSeen(uint8_t event);
+	uint32_t getWindowCount(uint8_t event);
+	uint32_t getRatePerHour(uint8_t event, uint32_t now);
+	BQ25672EventSet getSeenEvents();
+
+	// Layout (little endian): version, timestamp (4), seen mask (6),
+	// then per seen flag in bit order: count (4), last seen (4), window count (2)
+	uint16_t exportRecord(uint8_t *buffer, uint16_t size, uint32_t now);
+
+private:
+	uint32_t window_time;
+	uint32_t window_start;
+	uint8_t elapsed_windows;  // Completed windows since reset(), at most BQ25672_STATISTICS_WINDOWS
+
+	// Bit k of plane[n] is bit n of the running window count of flag k
+	uint64_t planes[BQ25672_STATISTICS_PLANES];
+
+	uint32_t totals[BQ25672_EVENT_COUNT];
+	uint32_t last_seen[BQ25672_EVENT_COUNT];
+	uint16_t history[BQ25672_STATISTICS_WINDOWS][BQ25672_EVENT_COUNT];
+	uint8_t history_head;
+	BQ25672EventSet seen;
+
+	uint16_t planeCount(uint8_t event);
+	void closeWindow();
+};
+#endif /* BQ25672_FLAG_STATISTICS_H_ */
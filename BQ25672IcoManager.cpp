@@ -0,0 +1,183 @@
+/*
+  FILE:    BQ25672IcoManager.cpp
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Runs the BQ25672 input current optimizer once per input source
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#include "BQ25672IcoManager.h"
+
+#define ICO_CONTROL_REGISTER 0x0F
+#define EN_ICO_BIT 0x10
+#define FORCE_ICO_BIT 0x08
+
+#define ICO_STATUS_DONE 2  // Max. input current detected
+
+BQ25672IcoManager::BQ25672IcoManager(BQ25672 *charger):
+	_charger(charger), _arbiter(NULL), timeout(10000), state(BQ25672_ICO_IDLE), signature(0), limit(0), start_time(0),
+	cache_fill(0), optimize_count(0), cache_hit_count(0), timeout_count(0) {
+}
+
+void BQ25672IcoManager::setLimitArbiter(BQ25672LimitArbiter *arbiter){
+	_arbiter = arbiter;
+}
+
+void BQ25672IcoManager::setTimeout(uint32_t new_timeout){
+	timeout = new_timeout;
+}
+
+void BQ25672IcoManager::clearCache(){
+	cache_fill = 0;
+}
+
+bool BQ25672IcoManager::process(BQ25672EventSet flags, const BQ25672StatusSnapshot *status, uint16_t source_id){
+	uint32_t timestamp = status->timestamp;
+
+	// VBUS_STAT is only valid once detection is done
+	bool attached = BQ25672::getStatusField(status, BQ25672_STATUS_POWER_GOOD) && BQ25672::getStatusField(status, BQ25672_STATUS_BC12_DONE);
+	if(!attached){
+		if(state == BQ25672_ICO_IDLE) return true;
+		state = BQ25672_ICO_IDLE;
+		limit = 0;
+		return _arbiter == NULL || _arbiter->release(BQ25672_LIMIT_INPUT_CURRENT, BQ25672_LIMIT_CLIENT_ICO_MANAGER);
+	}
+
+	uint32_t new_signature = ((uint32_t) source_id << 4) | BQ25672::getStatusField(status, BQ25672_STATUS_VBUS_STATUS);
+	if(state == BQ25672_ICO_IDLE || new_signature != signature){
+		signature = new_signature;
+		return attach(timestamp);
+	}
+
+	if(state == BQ25672_ICO_OPTIMIZING){
+		if((flags & BQ25672_EVENT_BIT(BQ25672_EVENT_ICO)) && BQ25672::getStatusField(status, BQ25672_STATUS_ICO_STATUS) == ICO_STATUS_DONE){
+			int new_limit = _charger->getInputCurrentLimit();
+			if(new_limit == 0) return false;
+
+			if(signature >> 4 != 0) storeCache(signature, new_limit);
+			return finish(new_limit);
+		}
+
+		if(timestamp - start_time >= timeout){
+			// Keep the limit that is set, do not try again for this source until it reports poor.
+			// optimize() already erased a cached limit, so the source is optimized at the next attach.
+			timeout_count++;
+			state = BQ25672_ICO_READY;
+			return writeIcoControl(false, false);
+		}
+		return true;
+	}
+
+	if(flags & BQ25672_EVENT_BIT(BQ25672_EVENT_POOR_SOURCE)) return optimize(timestamp);
+	return true;
+}
+
+uint8_t BQ25672IcoManager::getState(){
+	return state;
+}
+
+uint32_t BQ25672IcoManager::getSignature(){
+	return signature;
+}
+
+int BQ25672IcoManager::getLimit(){
+	// Returns value in: mA
+	return limit;
+}
+
+uint8_t BQ25672IcoManager::getCacheCount(){
+	return cache_fill;
+}
+
+int BQ25672IcoManager::getCacheEntry(uint8_t index, uint32_t *entry_signature){
+	// Returns value in: mA, 0 if not available
+	if(index >= cache_fill) return 0;
+
+	if(entry_signature != NULL) *entry_signature = cache_signature[index];
+	return cache_limit[index];
+}
+
+uint32_t BQ25672IcoManager::getOptimizeCount(){
+	return optimize_count;
+}
+
+uint32_t BQ25672IcoManager::getCacheHitCount(){
+	return cache_hit_count;
+}
+
+uint32_t BQ25672IcoManager::getTimeoutCount(){
+	return timeout_count;
+}
+
+bool BQ25672IcoManager::attach(uint32_t timestamp){
+	int8_t index = findCache(signature);
+	if(index < 0) return optimize(timestamp);
+
+	cache_hit_count++;
+	return finish(cache_limit[index]);
+}
+
+bool BQ25672IcoManager::optimize(uint32_t timestamp){
+	// A cached limit was not good enough, a timed out optimization must not leave it behind
+	int8_t index = findCache(signature);
+	if(index >= 0) eraseCache(index);
+
+	// The limit set in IINDPM is the ceiling ICO searches below, without our old result
+	optimize_count++;
+	state = BQ25672_ICO_OPTIMIZING;
+	start_time = timestamp;
+	limit = 0;
+	bool released = _arbiter == NULL || _arbiter->release(BQ25672_LIMIT_INPUT_CURRENT, BQ25672_LIMIT_CLIENT_ICO_MANAGER);
+	return writeIcoControl(true, true) && released;
+}
+
+bool BQ25672IcoManager::finish(int new_limit){
+	// IINDPM first, it takes over from the ICO limit when ICO is disabled
+	limit = new_limit;
+	state = BQ25672_ICO_READY;
+	bool success;
+	if(_arbiter != NULL) success = _arbiter->request(BQ25672_LIMIT_INPUT_CURRENT, BQ25672_LIMIT_CLIENT_ICO_MANAGER, limit);
+	else success = _charger->setInputCurrentLimitRegister(limit);
+	return writeIcoControl(false, false) && success;
+}
+
+bool BQ25672IcoManager::writeIcoControl(bool enable, bool force){
+	// EN_ICO and FORCE_ICO in one read and one write
+	uint8_t data;
+	if(!_charger->readRegisters(ICO_CONTROL_REGISTER, &data, 1)) return false;
+
+	uint8_t new_data = data & ~(EN_ICO_BIT | FORCE_ICO_BIT);
+	if(enable) new_data |= EN_ICO_BIT;
+	if(force) new_data |= FORCE_ICO_BIT;
+	if(new_data == data) return true;
+
+	return _charger->writeRegisters(ICO_CONTROL_REGISTER, &new_data, 1);
+}
+
+int8_t BQ25672IcoManager::findCache(uint32_t cache_key){
+	for(int i = 0; i < cache_fill; i++){
+		if(cache_signature[i] == cache_key) return i;
+	}
+	return -1;
+}
+
+void BQ25672IcoManager::storeCache(uint32_t cache_key, int cache_value){
+	// Update a known source, otherwise append it and drop the oldest entry when full
+	int8_t index = findCache(cache_key);
+	if(index < 0){
+		if(cache_fill == BQ25672_ICO_CACHE_SIZE) eraseCache(0);
+		index = cache_fill++;
+	}
+	cache_signature[index] = cache_key;
+	cache_limit[index] = cache_value;
+}
+
+void BQ25672IcoManager::eraseCache(uint8_t index){
+	// Keeps the entries ordered from oldest to newest
+	for(int i = index; i + 1 < cache_fill; i++){
+		cache_signature[i] = cache_signature[i + 1];
+		cache_limit[i] = cache_limit[i + 1];
+	}
+	cache_fill--;
+}
@@ -0,0 +1,80 @@
+/*
+  FILE:    BQ25672IcoManager.h
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Runs the BQ25672 input current optimizer once per input source
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#ifndef BQ25672_ICO_MANAGER_H_
+#define BQ25672_ICO_MANAGER_H_
+
+#include "BQ25672.h"
+#include "BQ25672LimitArbiter.h"
+
+// Sources whose optimized input current limit is remembered
+#ifndef BQ25672_ICO_CACHE_SIZE
+#define BQ25672_ICO_CACHE_SIZE 8
+#endif
+
+#define BQ25672_ICO_IDLE 0  // No detected input
+#define BQ25672_ICO_OPTIMIZING 1  // Waiting for the ICO status event
+#define BQ25672_ICO_READY 2  // Input current limit set, ICO disabled
+
+// A source is attached when power good and BC1.2 done are both set. Its
+// signature is the VBUS_STAT code plus an id from the caller that tells
+// adapters apart, e.g. from their USB PD identity. Adapters of one type can
+// be of very different quality, so source_id 0 (unknown adapter) is never
+// cached. A known signature gets its cached limit written right away, an
+// unknown one starts ICO. The result of ICO (REG19) is cached, written to
+// IINDPM and ICO is disabled again, so the charger does not re-optimize
+// behind our back. A poor source flag erases the cached limit and optimizes
+// again, a timed out optimization leaves the source uncached.
+class BQ25672IcoManager {
+public:
+	BQ25672IcoManager(BQ25672 *charger);
+
+	void setTimeout(uint32_t timeout);  // ms, ICO is given up after this time
+	void setLimitArbiter(BQ25672LimitArbiter *arbiter);  // NULL = write the registers directly
+	void clearCache();
+
+	// Call with the flags and the status snapshot they were taken from, returns false on a bus error
+	bool process(BQ25672EventSet flags, const BQ25672StatusSnapshot *status, uint16_t source_id);
+
+	uint8_t getState();
+	uint32_t getSignature();
+	int getLimit();  // mA, the limit in use, 0 when not ready
+	uint8_t getCacheCount();
+	int getCacheEntry(uint8_t index, uint32_t *signature = NULL);  // mA, index < getCacheCount(), oldest first
+	uint32_t getOptimizeCount();
+	uint32_t getCacheHitCount();
+	uint32_t getTimeoutCount();
+
+private:
+	BQ25672 *_charger;
+	BQ25672LimitArbiter *_arbiter;
+	uint32_t timeout;
+
+	uint8_t state;
+	uint32_t signature;
+	int limit;
+	uint32_t start_time;
+
+	uint32_t cache_signature[BQ25672_ICO_CACHE_SIZE];
+	int16_t cache_limit[BQ25672_ICO_CACHE_SIZE];
+	uint8_t cache_fill;
+
+	uint32_t optimize_count;
+	uint32_t cache_hit_count;
+	uint32_t timeout_count;
+
+	bool attach(uint32_t timestamp);
+	bool optimize(uint32_t timestamp);
+	bool finish(int new_limit);
+	bool writeIcoControl(bool enable, bool force);
+	int8_t findCache(uint32_t cache_key);
+	void storeCache(uint32_t cache_key, int cache_value);
+	void eraseCache(uint8_t index);
+};
+#endif /* BQ25672_ICO_MANAGER_H_ */
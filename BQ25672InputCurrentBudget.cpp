@@ -0,0 +1,188 @@
+/*
+  FILE:    BQ25672InputCurrentBudget.cpp
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Shares the adapter current between the system load and the BQ25672 charger
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#include "BQ25672InputCurrentBudget.h"
+
+#define CURRENT_LSB 10  // mA, of REG03 and REG06
+#define INPUT_CURRENT_LIMIT_MIN 100  // mA
+#define INPUT_CURRENT_LIMIT_MAX 3300  // mA
+#define CHARGE_CURRENT_MIN 50  // mA
+#define CHARGE_CURRENT_MAX 5000  // mA
+#define INCREASE_MIN 20  // mA, smaller increases wait until they add up, unless the target is reached
+#define BUS_VOLTAGE_MIN 3000  // mV, below this there is no adapter to share
+
+BQ25672InputCurrentBudget::BQ25672InputCurrentBudget(BQ25672 *charger):
+	_charger(charger), _arbiter(NULL), budget(INPUT_CURRENT_LIMIT_MIN), max_charge_current(CHARGE_CURRENT_MIN),
+	margin(100), slew_rate(1000), write_interval(50),
+	input_current_limit(-1), charge_current(-1), system_current(0),
+	input_ramp(0), charge_ramp(0), last_update(0), last_input_write(0), last_charge_write(0), write_count(0), write_errors(0) {
+}
+
+void BQ25672InputCurrentBudget::setLimitArbiter(BQ25672LimitArbiter *arbiter){
+	_arbiter = arbiter;
+}
+
+bool BQ25672InputCurrentBudget::begin(int new_budget, int new_max_charge_current){
+	setBudget(new_budget);
+	setMaxChargeCurrent(new_max_charge_current);
+	system_current = 0;
+
+	// Start at the budget and the lowest charge current, the charge current ramps up from there
+	uint32_t now = millis();
+	input_current_limit = -1;
+	charge_current = -1;
+	last_update = now;
+	bool success = writeChargeCurrent(CHARGE_CURRENT_MIN, now);
+	success &= writeInputCurrentLimit(budget, now);
+	return success;
+}
+
+void BQ25672InputCurrentBudget::setBudget(int new_budget){
+	if(new_budget < INPUT_CURRENT_LIMIT_MIN) new_budget = INPUT_CURRENT_LIMIT_MIN;
+	if(new_budget > INPUT_CURRENT_LIMIT_MAX) new_budget = INPUT_CURRENT_LIMIT_MAX;
+	budget = new_budget;
+}
+
+void BQ25672InputCurrentBudget::setMaxChargeCurrent(int new_max_charge_current){
+	if(new_max_charge_current < CHARGE_CURRENT_MIN) new_max_charge_current = CHARGE_CURRENT_MIN;
+	if(new_max_charge_current > CHARGE_CURRENT_MAX) new_max_charge_current = CHARGE_CURRENT_MAX;
+	max_charge_current = new_max_charge_current;
+}
+
+void BQ25672InputCurrentBudget::setMargin(int new_margin){
+	margin = new_margin;
+}
+
+void BQ25672InputCurrentBudget::setSlewRate(int new_slew_rate){
+	slew_rate = new_slew_rate;
+}
+
+void BQ25672InputCurrentBudget::setWriteInterval(uint32_t new_write_interval){
+	write_interval = new_write_interval;
+}
+
+bool BQ25672InputCurrentBudget::update(const BQ25672AdcSnapshot *snapshot){
+	int32_t bus_voltage = snapshot->bus_voltage;
+	int32_t battery_voltage = snapshot->battery_voltage;
+
+	// The ramps move with the time since the previous update
+	uint32_t now = snapshot->timestamp;
+	uint32_t elapsed = now - last_update;
+	last_update = now;
+	if(bus_voltage < BUS_VOLTAGE_MIN || battery_voltage <= 0) return true;
+
+	// The input current of the charger follows from the battery power, the rest is system load
+	int32_t input_current = snapshot->input_current > 0 ? snapshot->input_current : 0;
+	int32_t charging_current = snapshot->battery_current > 0 ? snapshot->battery_current : 0;
+	int32_t charger_input_current = (int64_t) charging_current * battery_voltage * 100 / (bus_voltage * BQ25672_BUDGET_EFFICIENCY);
+	system_current = input_current - charger_input_current;
+	if(system_current < 0) system_current = 0;
+
+	int new_input_current_limit = ramp(budget, input_current_limit, &input_ramp, elapsed, now - last_input_write);
+
+	// Whatever the system leaves over goes to the battery
+	int32_t available = new_input_current_limit - margin - system_current;
+	int32_t charge_target = (int64_t) available * bus_voltage * BQ25672_BUDGET_EFFICIENCY / (battery_voltage * 100);
+	if(charge_target < CHARGE_CURRENT_MIN) charge_target = CHARGE_CURRENT_MIN;
+	if(charge_target > max_charge_current) charge_target = max_charge_current;
+	int new_charge_current = ramp(charge_target, charge_current, &charge_ramp, elapsed, now - last_charge_write);
+
+	// Lower the charge current before the input current limit and raise it after,
+	// so the input current limit never cuts into the system load
+	bool success = true;
+	if(new_charge_current < charge_current){
+		success &= writeChargeCurrent(new_charge_current, now);
+	}
+	if(new_input_current_limit != input_current_limit){
+		success &= writeInputCurrentLimit(new_input_current_limit, now);
+	}
+	if(new_charge_current > charge_current){
+		success &= writeChargeCurrent(new_charge_current, now);
+	}
+	return success;
+}
+
+int BQ25672InputCurrentBudget::getInputCurrentLimit(){
+	// Returns value in: mA
+	return input_current_limit;
+}
+
+int BQ25672InputCurrentBudget::getChargeCurrent(){
+	// Returns value in: mA
+	return charge_current;
+}
+
+int BQ25672InputCurrentBudget::getSystemCurrent(){
+	// Returns value in: mA
+	return system_current;
+}
+
+uint32_t BQ25672InputCurrentBudget::getWriteCount(){
+	return write_count;
+}
+
+uint32_t BQ25672InputCurrentBudget::getWriteErrorCount(){
+	return write_errors;
+}
+
+int BQ25672InputCurrentBudget::ramp(int target, int written, int32_t *ramp_value, uint32_t elapsed, uint32_t since_write){
+	target = (target / CURRENT_LSB) * CURRENT_LSB;
+	if(target <= written){
+		// Reductions are not delayed
+		*ramp_value = (int32_t) target * 1000;
+		return target;
+	}
+
+	// The ramp value moves with the slew rate, writes only catch up with it
+	int32_t limit = (int32_t) target * 1000;
+	if(*ramp_value < (int32_t) written * 1000) *ramp_value = (int32_t) written * 1000;
+	if(*ramp_value > limit) *ramp_value = limit;  // The target dropped while the ramp was ahead of it
+	uint64_t step = (uint64_t) slew_rate * elapsed;  // uA
+	*ramp_value = step >= (uint64_t)(limit - *ramp_value) ? limit : *ramp_value + (int32_t) step;
+
+	if(since_write < write_interval){
+		return written;
+	}
+
+	// Small increases are coalesced until they add up, unless the target is reached
+	int value = (*ramp_value / 1000 / CURRENT_LSB) * CURRENT_LSB;
+	return value == target || value - written >= INCREASE_MIN ? value : written;
+}
+
+bool BQ25672InputCurrentBudget::writeInputCurrentLimit(int new_value, uint32_t timestamp){
+	bool success;
+	if(_arbiter != NULL) success = _arbiter->request(BQ25672_LIMIT_INPUT_CURRENT, BQ25672_LIMIT_CLIENT_INPUT_BUDGET, new_value);
+	else success = _charger == NULL || _charger->setInputCurrentLimitRegister(new_value);
+
+	if(!success){
+		write_errors++;
+		return false;
+	}
+
+	input_current_limit = new_value;
+	last_input_write = timestamp;
+	write_count++;
+	return true;
+}
+
+bool BQ25672InputCurrentBudget::writeChargeCurrent(int new_value, uint32_t timestamp){
+	bool success;
+	if(_arbiter != NULL) success = _arbiter->request(BQ25672_LIMIT_CHARGE_CURRENT, BQ25672_LIMIT_CLIENT_INPUT_BUDGET, new_value);
+	else success = _charger == NULL || _charger->setChargeCurrent(new_value);
+
+	if(!success){
+		write_errors++;
+		return false;
+	}
+
+	charge_current = new_value;
+	last_charge_write = timestamp;
+	write_count++;
+	return true;
+}
@@ -0,0 +1,67 @@
+/*
+  FILE:    BQ25672InputCurrentBudget.h
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Shares the adapter current between the system load and the BQ25672 charger
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#ifndef BQ25672_INPUT_CURRENT_BUDGET_H_
+#define BQ25672_INPUT_CURRENT_BUDGET_H_
+
+#include "BQ25672.h"
+#include "BQ25672LimitArbiter.h"
+
+#define BQ25672_BUDGET_EFFICIENCY 90  // %, assumed converter efficiency to map IBAT on IBUS
+
+// Keeps the adapter below its budget: the input current limit follows the
+// budget and the charge current gets what the system load leaves over.
+// Reductions are written right away, so the system load has priority.
+// Increases are ramped with the slew rate and coalesced into at most one
+// write per write interval.
+class BQ25672InputCurrentBudget {
+public:
+	BQ25672InputCurrentBudget(BQ25672 *charger);  // charger may be NULL for simulations
+
+	bool begin(int budget, int max_charge_current);  // mA
+	void setBudget(int budget);  // mA, e.g. after a new adapter is detected
+	void setMaxChargeCurrent(int max_charge_current);  // mA
+	void setMargin(int margin);  // mA of input current kept free for load steps
+	void setSlewRate(int slew_rate);  // mA/s, ramp up of the input current limit and the charge current
+	void setWriteInterval(uint32_t write_interval);  // ms, minimum time between increases
+	void setLimitArbiter(BQ25672LimitArbiter *arbiter);  // NULL = write the registers directly
+
+	bool update(const BQ25672AdcSnapshot *snapshot);  // Returns false on a write error
+
+	int getInputCurrentLimit();  // mA, as written
+	int getChargeCurrent();  // mA, as written
+	int getSystemCurrent();  // mA, estimated input current of the system load
+	uint32_t getWriteCount();
+	uint32_t getWriteErrorCount();
+
+private:
+	BQ25672 *_charger;
+	BQ25672LimitArbiter *_arbiter;
+	int budget;
+	int max_charge_current;
+	int margin;
+	int slew_rate;
+	uint32_t write_interval;
+
+	int input_current_limit;
+	int charge_current;
+	int system_current;
+	int32_t input_ramp;  // uA, ramped value ahead of the written one
+	int32_t charge_ramp;  // uA
+	uint32_t last_update;
+	uint32_t last_input_write;
+	uint32_t last_charge_write;
+	uint32_t write_count;
+	uint32_t write_errors;
+
+	int ramp(int target, int written, int32_t *ramp_value, uint32_t elapsed, uint32_t since_write);
+	bool writeInputCurrentLimit(int new_value, uint32_t timestamp);
+	bool writeChargeCurrent(int new_value, uint32_t timestamp);
+};
+#endif /* BQ25672_INPUT_CURRENT_BUDGET_H_ */
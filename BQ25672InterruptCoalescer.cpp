@@ -0,0 +1,148 @@
+/*
+  FILE:    BQ25672InterruptCoalescer.cpp
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Temporarily masks BQ25672 interrupts that fire too often
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#include "BQ25672InterruptCoalescer.h"
+
+BQ25672InterruptCoalescer::BQ25672InterruptCoalescer(BQ25672 *charger):
+	_charger(charger), subscribed(BQ25672_EVENTS_ALL), suppressed(0), written(BQ25672_EVENTS_ALL),
+	max_count(10), window_time(1000), holdoff_time(5000), slot_count(0) {
+	watch(BQ25672_EVENT_VINDPM);
+	watch(BQ25672_EVENT_IINDPM);
+}
+
+bool BQ25672InterruptCoalescer::begin(BQ25672EventSet subscribed_events){
+	subscribed = subscribed_events;
+	suppressed = 0;
+	for(int i = 0; i < slot_count; i++){
+		slot_count_in_window[i] = 0;
+	}
+
+	bool success = _charger->subscribe(subscribed);
+	written = success ? subscribed : ~subscribed;
+	return success;
+}
+
+void BQ25672InterruptCoalescer::setLimits(uint16_t new_max_count, uint32_t new_window_time, uint32_t new_holdoff_time){
+	max_count = new_max_count > 0 ? new_max_count : 1;
+	window_time = new_window_time;
+	holdoff_time = new_holdoff_time;
+}
+
+bool BQ25672InterruptCoalescer::watch(uint8_t event){
+	if(event >= BQ25672_EVENT_COUNT) return false;
+	if(findSlot(event) >= 0) return true;
+	if(slot_count >= BQ25672_COALESCER_MAX_EVENTS) return false;
+
+	slot_event[slot_count] = event;
+	slot_count_in_window[slot_count] = 0;
+	slot_time[slot_count] = 0;
+	slot_suppressed[slot_count] = 0;
+	slot_count++;
+	return true;
+}
+
+void BQ25672InterruptCoalescer::unwatch(uint8_t event){
+	int slot = findSlot(event);
+	if(slot < 0) return;
+
+	suppressed &= ~BQ25672_EVENT_BIT(event);
+
+	slot_count--;
+	slot_event[slot] = slot_event[slot_count];
+	slot_count_in_window[slot] = slot_count_in_window[slot_count];
+	slot_time[slot] = slot_time[slot_count];
+	slot_suppressed[slot] = slot_suppressed[slot_count];
+
+	writeMasks();
+}
+
+void BQ25672InterruptCoalescer::process(BQ25672EventSet flags, uint32_t now){
+	BQ25672EventSet previous = suppressed;
+
+	for(int i = 0; i < slot_count; i++){
+		BQ25672EventSet bit = BQ25672_EVENT_BIT(slot_event[i]);
+		if(!(flags & bit)) continue;
+
+		if(suppressed & bit){
+			if(slot_suppressed[i] < UINT32_MAX) slot_suppressed[i]++;
+			continue;
+		}
+
+		if(now - slot_time[i] >= window_time){
+			slot_time[i] = now;
+			slot_count_in_window[i] = 0;
+		}
+
+		slot_count_in_window[i]++;
+		if(slot_count_in_window[i] >= max_count){
+			suppressed |= bit;
+			slot_time[i] = now;
+			slot_count_in_window[i] = 0;
+		}
+	}
+
+	if(suppressed != previous){
+		writeMasks();
+	}
+	update(now);
+}
+
+void BQ25672InterruptCoalescer::update(uint32_t now){
+	BQ25672EventSet previous = suppressed;
+
+	for(int i = 0; i < slot_count; i++){
+		BQ25672EventSet bit = BQ25672_EVENT_BIT(slot_event[i]);
+		if((suppressed & bit) && now - slot_time[i] >= holdoff_time){
+			suppressed &= ~bit;
+			slot_time[i] = now;
+		}
+	}
+
+	if(suppressed != previous || written != (subscribed & ~suppressed)){
+		writeMasks();
+	}
+}
+
+bool BQ25672InterruptCoalescer::isSuppressed(uint8_t event){
+	if(event >= BQ25672_EVENT_COUNT) return false;
+	return suppressed & BQ25672_EVENT_BIT(event);
+}
+
+uint32_t BQ25672InterruptCoalescer::getSuppressedCount(uint8_t event){
+	int slot = findSlot(event);
+	if(slot < 0) return 0;
+	return slot_suppressed[slot];
+}
+
+BQ25672EventSet BQ25672InterruptCoalescer::getSuppressedEvents(){
+	return suppressed;
+}
+
+BQ25672EventSet BQ25672InterruptCoalescer::getActiveEvents(){
+	return subscribed & ~suppressed;
+}
+
+int BQ25672InterruptCoalescer::findSlot(uint8_t event){
+	for(int i = 0; i < slot_count; i++){
+		if(slot_event[i] == event) return i;
+	}
+	return -1;
+}
+
+bool BQ25672InterruptCoalescer::writeMasks(){
+	// Only writes the mask registers when the active set changed, retried from update() on failure
+	BQ25672EventSet active = subscribed & ~suppressed;
+	if(active == written) return true;
+
+	bool success = _charger->subscribe(active);
+	if(success){
+		written = active;
+	}
+	return success;
+}
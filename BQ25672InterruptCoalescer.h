@@ -0,0 +1,59 @@
+/*
+  FILE:    BQ25672InterruptCoalescer.h
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Temporarily masks BQ25672 interrupts that fire too often
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#ifndef BQ25672_INTERRUPT_COALESCER_H_
+#define BQ25672_INTERRUPT_COALESCER_H_
+
+#include "BQ25672.h"
+
+#ifndef BQ25672_COALESCER_MAX_EVENTS
+#define BQ25672_COALESCER_MAX_EVENTS 8
+#endif
+
+// An event that occurs max_count times within window_time is masked for
+// holdoff_time. Masked events still latch their flag, every readFlags() that
+// finds such a flag counts as one suppressed occurrence.
+class BQ25672InterruptCoalescer {
+public:
+	BQ25672InterruptCoalescer(BQ25672 *charger);  // Watches VINDPM and IINDPM by default
+
+	bool begin(BQ25672EventSet subscribed_events);
+	void setLimits(uint16_t max_count, uint32_t window_time, uint32_t holdoff_time);  // Times in ms
+
+	bool watch(uint8_t event);
+	void unwatch(uint8_t event);
+
+	void process(BQ25672EventSet flags, uint32_t now);  // Call after readFlags() with getFlags()
+	void update(uint32_t now);  // Call regularly to unmask events after the hold-off
+
+	bool isSuppressed(uint8_t event);
+	uint32_t getSuppressedCount(uint8_t event);
+	BQ25672EventSet getSuppressedEvents();
+	BQ25672EventSet getActiveEvents();
+
+private:
+	BQ25672 *_charger;
+	BQ25672EventSet subscribed;
+	BQ25672EventSet suppressed;
+	BQ25672EventSet written;
+
+	uint16_t max_count;
+	uint32_t window_time;
+	uint32_t holdoff_time;
+
+	uint8_t slot_count;
+	uint8_t slot_event[BQ25672_COALESCER_MAX_EVENTS];
+	uint16_t slot_count_in_window[BQ25672_COALESCER_MAX_EVENTS];
+	uint32_t slot_time[BQ25672_COALESCER_MAX_EVENTS];  // Window start, or unmask time while suppressed
+	uint32_t slot_suppressed[BQ25672_COALESCER_MAX_EVENTS];
+
+	int findSlot(uint8_t event);
+	bool writeMasks();
+};
+#endif /* BQ25672_INTERRUPT_COALESCER_H_ */
@@ -0,0 +1,137 @@
+/*
+  FILE:    BQ25672InterruptTask.cpp
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: FreeRTOS task that handles the BQ25672 INT pin outside of the ISR
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#include "BQ25672InterruptTask.h"
+
+#ifdef BQ25672_HAS_FREERTOS
+
+BQ25672InterruptTask::BQ25672InterruptTask(BQ25672 *charger, BQ25672EventQueue *queue):
+	_charger(charger), _queue(queue), task_handle(NULL), bus_mutex(NULL), stop_requested(false), processed_count(0), read_errors(0) {
+}
+
+BQ25672InterruptTask::~BQ25672InterruptTask() {
+	end();
+	if(bus_mutex != NULL){
+		vSemaphoreDelete(bus_mutex);
+	}
+}
+
+bool BQ25672InterruptTask::begin(UBaseType_t priority, uint32_t stack_size, int core){
+	if(task_handle != NULL) return true;
+
+	if(bus_mutex == NULL){
+		bus_mutex = xSemaphoreCreateMutex();
+		if(bus_mutex == NULL) return false;
+	}
+	_charger->setBusLock(busLock, this);
+	stop_requested = false;
+
+	TaskHandle_t handle = NULL;
+#if defined(ESP32)
+	// ESP-IDF takes the stack size in bytes
+	BaseType_t affinity = core < 0 ? tskNO_AFFINITY : core;
+	BaseType_t result = xTaskCreatePinnedToCore(taskEntry, "BQ25672", stack_size, this, priority, &handle, affinity);
+#else
+	(void) core;
+	BaseType_t result = xTaskCreate(taskEntry, "BQ25672", stack_size / sizeof(StackType_t), this, priority, &handle);
+#endif
+
+	if(result != pdPASS){
+		_charger->setBusLock(NULL);
+		return false;
+	}
+	task_handle = handle;
+	return true;
+}
+
+void BQ25672InterruptTask::end(){
+	// Deleting the task from here could stop it in the middle of a bus
+	// transaction with the bus mutex taken, so the task deletes itself
+	TaskHandle_t handle = task_handle;
+	if(handle == NULL) return;
+
+	stop_requested = true;
+	xTaskNotifyGive(handle);
+	if(handle == xTaskGetCurrentTaskHandle()) return;
+
+	while(task_handle != NULL){
+		vTaskDelay(1);
+	}
+
+	// Wait for other users of the bus before the lock is removed
+	xSemaphoreTake(bus_mutex, portMAX_DELAY);
+	_charger->setBusLock(NULL);
+	xSemaphoreGive(bus_mutex);
+}
+
+void BQ25672_ISR_ATTR BQ25672InterruptTask::notifyFromIsr(){
+	TaskHandle_t handle = task_handle;
+	if(handle == NULL) return;
+
+	if(_queue != NULL){
+		_queue->pushInterrupt(xTaskGetTickCountFromISR() * portTICK_PERIOD_MS);
+	}
+
+	BaseType_t higher_priority_task_woken = pdFALSE;
+	vTaskNotifyGiveFromISR(handle, &higher_priority_task_woken);
+#if defined(ESP32)
+	if(higher_priority_task_woken){
+		portYIELD_FROM_ISR();
+	}
+#else
+	portYIELD_FROM_ISR(higher_priority_task_woken);
+#endif
+}
+
+TaskHandle_t BQ25672InterruptTask::getTaskHandle(){
+	return task_handle;
+}
+
+uint32_t BQ25672InterruptTask::getProcessedCount(){
+	return processed_count;
+}
+
+uint32_t BQ25672InterruptTask::getReadErrorCount(){
+	return read_errors;
+}
+
+void BQ25672InterruptTask::taskEntry(void *parameter){
+	((BQ25672InterruptTask *) parameter)->run();
+}
+
+void BQ25672InterruptTask::busLock(bool lock, void *context){
+	BQ25672InterruptTask *task = (BQ25672InterruptTask *) context;
+	if(lock){
+		xSemaphoreTake(task->bus_mutex, portMAX_DELAY);
+	}
+	else{
+		xSemaphoreGive(task->bus_mutex);
+	}
+}
+
+void BQ25672InterruptTask::run(){
+	while(true){
+		// Notifications that arrive while the flags are being read are merged into one wake-up
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+		if(stop_requested) break;
+
+		if(_queue != NULL){
+			_queue->process(_charger);
+		}
+		else if(!_charger->readFlags()){
+			read_errors = read_errors + 1;
+		}
+		processed_count = processed_count + 1;
+	}
+
+	task_handle = NULL;
+	vTaskDelete(NULL);
+}
+
+#endif /* BQ25672_HAS_FREERTOS */
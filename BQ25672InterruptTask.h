@@ -0,0 +1,67 @@
+/*
+  FILE:    BQ25672InterruptTask.h
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: FreeRTOS task that handles the BQ25672 INT pin outside of the ISR
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#ifndef BQ25672_INTERRUPT_TASK_H_
+#define BQ25672_INTERRUPT_TASK_H_
+
+#include "BQ25672.h"
+#include "BQ25672EventQueue.h"
+
+// Available on ESP32, or on any other FreeRTOS target (e.g. the POSIX port
+// on a Linux host) when BQ25672_USE_FREERTOS is defined
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#define BQ25672_HAS_FREERTOS
+#elif defined(BQ25672_USE_FREERTOS)
+#include <FreeRTOS.h>
+#include <task.h>
+#include <semphr.h>
+#define BQ25672_HAS_FREERTOS
+#endif
+
+#ifdef BQ25672_HAS_FREERTOS
+
+class BQ25672InterruptTask {
+public:
+	// Without a queue the task only calls readFlags(), which passes the flags
+	// to the event dispatcher of the charger. With a queue, every interrupt
+	// is also recorded together with a status snapshot.
+	BQ25672InterruptTask(BQ25672 *charger, BQ25672EventQueue *queue = NULL);
+	~BQ25672InterruptTask();
+
+	// stack_size in bytes, core -1 = no core pinning (only used on ESP32).
+	// Also installs a mutex as bus lock of the charger, so components that use
+	// the charger from other tasks do not interleave with the task.
+	bool begin(UBaseType_t priority = configMAX_PRIORITIES - 1, uint32_t stack_size = 4096, int core = -1);
+	void end();  // Lets the task finish the current readout, then waits until it has deleted itself
+
+	void notifyFromIsr();  // Call from the INT pin ISR
+
+	TaskHandle_t getTaskHandle();
+	uint32_t getProcessedCount();
+	uint32_t getReadErrorCount();
+
+private:
+	BQ25672 *_charger;
+	BQ25672EventQueue *_queue;
+	TaskHandle_t volatile task_handle;  // Also read by the ISR
+	SemaphoreHandle_t bus_mutex;
+	volatile bool stop_requested;
+	volatile uint32_t processed_count;
+	volatile uint32_t read_errors;
+
+	static void taskEntry(void *parameter);
+	static void busLock(bool lock, void *context);
+	void run();
+};
+
+#endif /* BQ25672_HAS_FREERTOS */
+#endif /* BQ25672_INTERRUPT_TASK_H_ */
@@ -0,0 +1,118 @@
+/*
+  FILE:    BQ25672LimitArbiter.cpp
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Single owner of the BQ25672 input and charge current limits
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#include "BQ25672LimitArbiter.h"
+
+#define NO_REQUEST -1
+
+BQ25672LimitArbiter::BQ25672LimitArbiter(BQ25672 *charger):
+	_charger(charger), write_count(0), write_errors(0) {
+	for(int limit = 0; limit < BQ25672_LIMIT_COUNT; limit++){
+		for(int client = 0; client < BQ25672_LIMIT_CLIENT_COUNT; client++) requests[limit][client] = NO_REQUEST;
+		written[limit] = NO_REQUEST;
+		found[limit] = NO_REQUEST;
+		defaults[limit] = NO_REQUEST;
+	}
+}
+
+bool BQ25672LimitArbiter::request(uint8_t limit, uint8_t client, int value){
+	if(limit >= BQ25672_LIMIT_COUNT || client >= BQ25672_LIMIT_CLIENT_COUNT || value < 0 || value > INT16_MAX){
+		// Data is out of range
+		return false;
+	}
+
+	requests[limit][client] = value;
+	return write(limit);
+}
+
+bool BQ25672LimitArbiter::release(uint8_t limit, uint8_t client){
+	if(limit >= BQ25672_LIMIT_COUNT || client >= BQ25672_LIMIT_CLIENT_COUNT) return false;
+
+	requests[limit][client] = NO_REQUEST;
+	return write(limit);
+}
+
+void BQ25672LimitArbiter::invalidate(uint8_t limit){
+	// The value the charger wrote is the one to return to
+	if(limit >= BQ25672_LIMIT_COUNT) return;
+	written[limit] = NO_REQUEST;
+	found[limit] = NO_REQUEST;
+}
+
+void BQ25672LimitArbiter::setDefault(uint8_t limit, int value){
+	if(limit >= BQ25672_LIMIT_COUNT || value > INT16_MAX) return;
+	defaults[limit] = value < 0 ? NO_REQUEST : value;
+}
+
+int BQ25672LimitArbiter::getRequest(uint8_t limit, uint8_t client){
+	// Returns value in: mA
+	if(limit >= BQ25672_LIMIT_COUNT || client >= BQ25672_LIMIT_CLIENT_COUNT) return NO_REQUEST;
+	return requests[limit][client];
+}
+
+int BQ25672LimitArbiter::getLimit(uint8_t limit){
+	// Returns value in: mA
+	if(limit >= BQ25672_LIMIT_COUNT) return NO_REQUEST;
+	return written[limit];
+}
+
+int8_t BQ25672LimitArbiter::getOwner(uint8_t limit){
+	if(limit >= BQ25672_LIMIT_COUNT) return -1;
+
+	int8_t owner = -1;
+	for(int client = 0; client < BQ25672_LIMIT_CLIENT_COUNT; client++){
+		if(requests[limit][client] == NO_REQUEST) continue;
+		if(owner < 0 || requests[limit][client] < requests[limit][owner]) owner = client;
+	}
+	return owner;
+}
+
+uint32_t BQ25672LimitArbiter::getWriteCount(){
+	return write_count;
+}
+
+uint32_t BQ25672LimitArbiter::getWriteErrorCount(){
+	return write_errors;
+}
+
+bool BQ25672LimitArbiter::write(uint8_t limit){
+	int8_t owner = getOwner(limit);
+	if(owner < 0){
+		// Without requests the register returns to the default, or to the value before the first request
+		int16_t value = defaults[limit] != NO_REQUEST ? defaults[limit] : found[limit];
+		if(value == NO_REQUEST || value == written[limit]) return true;
+		if(!writeRegister(limit, value)) return false;
+		found[limit] = NO_REQUEST;
+		return true;
+	}
+
+	if(found[limit] == NO_REQUEST && defaults[limit] == NO_REQUEST && _charger != NULL){
+		// 0 is a read error, the register is then not restored
+		int value = limit == BQ25672_LIMIT_INPUT_CURRENT ? _charger->getInputCurrentLimitRegister() : _charger->getChargeCurrent();
+		if(value > 0) found[limit] = value;
+	}
+
+	int16_t value = requests[limit][owner];
+	if(value == written[limit]) return true;
+	return writeRegister(limit, value);
+}
+
+bool BQ25672LimitArbiter::writeRegister(uint8_t limit, int16_t value){
+	if(_charger != NULL){
+		bool success = limit == BQ25672_LIMIT_INPUT_CURRENT ? _charger->setInputCurrentLimitRegister(value) : _charger->setChargeCurrent(value);
+		if(!success){
+			write_errors++;
+			return false;
+		}
+	}
+
+	written[limit] = value;
+	write_count++;
+	return true;
+}
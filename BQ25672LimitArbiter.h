@@ -0,0 +1,66 @@
+/*
+  FILE:    BQ25672LimitArbiter.h
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Single owner of the BQ25672 input and charge current limits
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#ifndef BQ25672_LIMIT_ARBITER_H_
+#define BQ25672_LIMIT_ARBITER_H_
+
+#include "BQ25672.h"
+
+// Limits owned by the arbiter
+#define BQ25672_LIMIT_INPUT_CURRENT 0  // IINDPM, setInputCurrentLimitRegister()
+#define BQ25672_LIMIT_CHARGE_CURRENT 1  // ICHG, setChargeCurrent()
+#define BQ25672_LIMIT_COUNT 2
+
+// Clients, the components of the library use their own id
+#define BQ25672_LIMIT_CLIENT_SOURCE_MANAGER 0
+#define BQ25672_LIMIT_CLIENT_ICO_MANAGER 1
+#define BQ25672_LIMIT_CLIENT_INPUT_BUDGET 2
+#define BQ25672_LIMIT_CLIENT_THERMAL_DERATING 3
+#define BQ25672_LIMIT_CLIENT_CHARGE_ENGINE 4
+#define BQ25672_LIMIT_CLIENT_RESISTANCE_ESTIMATOR 5
+#define BQ25672_LIMIT_CLIENT_USER 6  // Free for the application
+#define BQ25672_LIMIT_CLIENT_COUNT 8
+
+// Several components want to set IINDPM and ICHG: the source manager, the
+// ICO manager and the input current budget the input current limit, the
+// budget, the thermal derating and the charge engine the charge current.
+// Written directly, the last write wins. With an arbiter attached every
+// component only requests its limit and the arbiter writes the lowest
+// request, and only when that changes. A failed write is retried with the
+// next request. The register value found at the first request (or the
+// default, when set) is written back when the last request is released, so
+// e.g. a derated charge current does not stay behind.
+class BQ25672LimitArbiter {
+public:
+	BQ25672LimitArbiter(BQ25672 *charger);  // charger may be NULL for simulations
+
+	bool request(uint8_t limit, uint8_t client, int value);  // mA, returns false on a write error
+	bool release(uint8_t limit, uint8_t client);  // The other requests decide, returns false on a write error
+	void invalidate(uint8_t limit);  // The charger changed the register itself, the next request writes it
+	void setDefault(uint8_t limit, int value);  // mA, written without requests, -1 = the value found at the first request
+
+	int getRequest(uint8_t limit, uint8_t client);  // mA, -1 = none
+	int getLimit(uint8_t limit);  // mA, as written, -1 = not written yet
+	int8_t getOwner(uint8_t limit);  // Client with the lowest request, -1 = none
+	uint32_t getWriteCount();
+	uint32_t getWriteErrorCount();
+
+private:
+	BQ25672 *_charger;
+	int16_t requests[BQ25672_LIMIT_COUNT][BQ25672_LIMIT_CLIENT_COUNT];  // -1 = none
+	int16_t written[BQ25672_LIMIT_COUNT];  // -1 = unknown
+	int16_t found[BQ25672_LIMIT_COUNT];  // Register value before the first request, -1 = unknown
+	int16_t defaults[BQ25672_LIMIT_COUNT];  // -1 = use found
+	uint32_t write_count;
+	uint32_t write_errors;
+
+	bool write(uint8_t limit);
+	bool writeRegister(uint8_t limit, int16_t value);
+};
+#endif /* BQ25672_LIMIT_ARBITER_H_ */
@@ -0,0 +1,187 @@
+/*
+  FILE:    BQ25672Mppt.cpp
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Software maximum power point tracking for solar inputs of the BQ25672
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#include "BQ25672Mppt.h"
+
+#define VINDPM_LSB 100  // mV
+#define VOLTAGE_NOISE 50  // mV, smaller VBUS changes count as no change
+#define HOLD_LIMIT 16  // Held snapshots before probing again, so slow irradiance changes are followed
+
+BQ25672Mppt::BQ25672Mppt(BQ25672 *charger, uint8_t algorithm):
+	_charger(charger), _algorithm(algorithm),
+	step_size(200), min_voltage(3600), max_voltage(22000), power_deadband(20), settle_time(0), convergence_reversals(3),
+	vindpm(0), direction(1), has_last(false), last_power(0), last_voltage(0), last_current(0), last_step_time(0),
+	reversal_history(0), hold_count(0), converged(false), step_count(0), write_errors(0) {
+}
+
+bool BQ25672Mppt::begin(int start_voltage){
+	has_last = false;
+	direction = 1;
+	reversal_history = 0;
+	hold_count = 0;
+	converged = false;
+
+	if(_charger != NULL && !_charger->setMpptEnabled(false)){
+		return false;
+	}
+
+	if(start_voltage < min_voltage) start_voltage = min_voltage;
+	if(start_voltage > max_voltage) start_voltage = max_voltage;
+	vindpm = -1;
+	return writeVindpm(start_voltage, millis());
+}
+
+void BQ25672Mppt::setAlgorithm(uint8_t algorithm){
+	_algorithm = algorithm;
+	has_last = false;
+}
+
+void BQ25672Mppt::setStepSize(int new_step_size){
+	new_step_size = (new_step_size / VINDPM_LSB) * VINDPM_LSB;
+	step_size = new_step_size > 0 ? new_step_size : VINDPM_LSB;
+}
+
+void BQ25672Mppt::setLimits(int new_min_voltage, int new_max_voltage){
+	min_voltage = new_min_voltage;
+	max_voltage = new_max_voltage;
+}
+
+void BQ25672Mppt::setPowerDeadband(int deadband){
+	power_deadband = deadband;
+}
+
+void BQ25672Mppt::setSettleTime(uint32_t new_settle_time){
+	settle_time = new_settle_time;
+}
+
+void BQ25672Mppt::setConvergenceReversals(uint8_t reversals){
+	convergence_reversals = reversals;
+}
+
+int BQ25672Mppt::update(const BQ25672AdcSnapshot *snapshot){
+	if(has_last && snapshot->timestamp - last_step_time < settle_time){
+		// The input has not settled after the last step yet
+		return vindpm;
+	}
+
+	int32_t voltage = snapshot->bus_voltage;
+	int32_t current = snapshot->input_current > 0 ? snapshot->input_current : 0;
+	int32_t power = voltage * current / 1000;
+
+	int8_t new_direction = direction;
+	if(has_last){
+		if(_algorithm == BQ25672_MPPT_INCREMENTAL_CONDUCTANCE){
+			new_direction = incrementalConductance(voltage, current);
+		}
+		else{
+			new_direction = perturbObserve(power);
+		}
+	}
+
+	has_last = true;
+	last_power = power;
+	last_voltage = voltage;
+	last_current = current;
+
+	if(new_direction == 0){
+		// At the maximum power point
+		converged = true;
+		if(++hold_count < HOLD_LIMIT){
+			return vindpm;
+		}
+		new_direction = direction;
+	}
+	hold_count = 0;
+
+	reversal_history = (reversal_history << 1) | (new_direction != direction);
+	direction = new_direction;
+	converged = __builtin_popcount(reversal_history) >= convergence_reversals;
+
+	int target = vindpm + direction * step_size;
+	if(target > max_voltage){
+		target = max_voltage;
+		direction = -1;
+	}
+	if(target < min_voltage){
+		target = min_voltage;
+		direction = 1;
+	}
+
+	writeVindpm(target, snapshot->timestamp);
+	return vindpm;
+}
+
+int BQ25672Mppt::getVindpm(){
+	// Returns value in: mV
+	return vindpm;
+}
+
+int32_t BQ25672Mppt::getPower(){
+	// Returns value in: mW, input power of the last used snapshot
+	return last_power;
+}
+
+bool BQ25672Mppt::isConverged(){
+	return converged;
+}
+
+uint32_t BQ25672Mppt::getStepCount(){
+	return step_count;
+}
+
+uint32_t BQ25672Mppt::getWriteErrorCount(){
+	return write_errors;
+}
+
+int8_t BQ25672Mppt::perturbObserve(int32_t power){
+	// Keep going while the power rises, reverse when it drops, hold when it is flat
+	int32_t delta_power = power - last_power;
+
+	if(delta_power < -power_deadband){
+		return -direction;
+	}
+	if(delta_power <= power_deadband){
+		return 0;
+	}
+	return direction;
+}
+
+int8_t BQ25672Mppt::incrementalConductance(int32_t voltage, int32_t current){
+	// dP/dV = I + V * dI/dV, which is zero at the maximum power point
+	int32_t delta_voltage = voltage - last_voltage;
+	int32_t delta_current = current - last_current;
+
+	if(delta_voltage > -VOLTAGE_NOISE && delta_voltage < VOLTAGE_NOISE){
+		if(abs(delta_current) * voltage / 1000 <= power_deadband){
+			return 0;
+		}
+		// Irradiance changed at the same voltage
+		return delta_current > 0 ? 1 : -1;
+	}
+
+	int32_t delta_power = (current * delta_voltage + voltage * delta_current) / 1000;  // mW
+	if(abs(delta_power) <= power_deadband){
+		return 0;
+	}
+	return ((delta_power > 0) == (delta_voltage > 0)) ? 1 : -1;
+}
+
+bool BQ25672Mppt::writeVindpm(int new_vindpm, uint32_t timestamp){
+	if(new_vindpm == vindpm) return true;
+
+	if(_charger != NULL && !_charger->setVindpmThreshold(new_vindpm)){
+		write_errors++;
+		return false;
+	}
+
+	vindpm = new_vindpm;
+	last_step_time = timestamp;
+	step_count++;
+	return true;
+}
@@ -0,0 +1,67 @@
+/*
+  FILE:    BQ25672Mppt.h
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Software maximum power point tracking for solar inputs of the BQ25672
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#ifndef BQ25672_MPPT_H_
+#define BQ25672_MPPT_H_
+
+#include "BQ25672.h"
+
+#define BQ25672_MPPT_PERTURB_OBSERVE 0
+#define BQ25672_MPPT_INCREMENTAL_CONDUCTANCE 1
+
+// Moves the VINDPM threshold towards the maximum power point of the input,
+// based on VBUS and IBUS of ADC snapshots. Disables the built-in MPPT.
+class BQ25672Mppt {
+public:
+	BQ25672Mppt(BQ25672 *charger, uint8_t algorithm = BQ25672_MPPT_PERTURB_OBSERVE);  // charger may be NULL for simulations
+
+	bool begin(int start_voltage);  // mV
+	void setAlgorithm(uint8_t algorithm);
+	void setStepSize(int step_size);  // mV, multiple of 100 mV
+	void setLimits(int min_voltage, int max_voltage);  // mV
+	void setPowerDeadband(int deadband);  // mW, smaller power changes count as no change
+	void setSettleTime(uint32_t settle_time);  // ms, snapshots taken sooner after a step are skipped
+	void setConvergenceReversals(uint8_t reversals);  // Direction reversals in the last 8 steps
+
+	int update(const BQ25672AdcSnapshot *snapshot);  // Returns the VINDPM threshold in mV
+
+	int getVindpm();
+	int32_t getPower();
+	bool isConverged();
+	uint32_t getStepCount();
+	uint32_t getWriteErrorCount();
+
+private:
+	BQ25672 *_charger;
+	uint8_t _algorithm;
+	int step_size;
+	int min_voltage;
+	int max_voltage;
+	int power_deadband;
+	uint32_t settle_time;
+	uint8_t convergence_reversals;
+
+	int vindpm;
+	int8_t direction;
+	bool has_last;
+	int32_t last_power;
+	int32_t last_voltage;
+	int32_t last_current;
+	uint32_t last_step_time;
+	uint8_t reversal_history;  // Bit n set = reversal n steps ago
+	uint8_t hold_count;
+	bool converged;
+	uint32_t step_count;
+	uint32_t write_errors;
+
+	int8_t perturbObserve(int32_t power);
+	int8_t incrementalConductance(int32_t voltage, int32_t current);
+	bool writeVindpm(int new_vindpm, uint32_t timestamp);
+};
+#endif /* BQ25672_MPPT_H_ */
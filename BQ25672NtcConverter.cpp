@@ -0,0 +1,79 @@
+/*
+  FILE:    BQ25672NtcConverter.cpp
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Converts the BQ25672 TS reading to a temperature with a lookup table
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#include "BQ25672NtcConverter.h"
+
+BQ25672NtcConverter::BQ25672NtcConverter() {
+	buildTable(3435, 10000, 5240, 30310);
+}
+
+BQ25672NtcConverter::BQ25672NtcConverter(float beta, float r25, float rt1, float rt2) {
+	buildTable(beta, r25, rt1, rt2);
+}
+
+void BQ25672NtcConverter::setParameters(float beta, float r25, float rt1, float rt2){
+	buildTable(beta, r25, rt1, rt2);
+}
+
+void BQ25672NtcConverter::buildTable(float beta, float r25, float rt1, float rt2){
+	// Values in: 0.1 C
+	const int16_t temp_max = 1500;
+	const int16_t temp_min = -500;
+
+	for(int i = 0; i < BQ25672_NTC_TABLE_SIZE; i++){
+		float ratio = (float)(i << BQ25672_NTC_TABLE_SHIFT) / 1024.0;
+
+		if(ratio <= 0){
+			table[i] = temp_max;  // TS shorted to ground
+			continue;
+		}
+		if(ratio >= 1){
+			table[i] = temp_min;  // TS open
+			continue;
+		}
+
+		// TS = REGN * R_low / (RT1 + R_low), with R_low = RT2 // R_ntc
+		float r_low = rt1 * ratio / (1 - ratio);
+		if(r_low >= rt2){
+			table[i] = temp_min;
+			continue;
+		}
+		float r_ntc = 1 / (1 / r_low - 1 / rt2);
+		float temp = 1 / (1 / 298.15 + log(r_ntc / r25) / beta) - 273.15;
+
+		int32_t deci = (int32_t)(temp * 10 + (temp < 0 ? -0.5 : 0.5));
+		if(deci > temp_max) deci = temp_max;
+		if(deci < temp_min) deci = temp_min;
+		table[i] = (int16_t) deci;
+	}
+}
+
+int BQ25672NtcConverter::toDeciCelsius(uint16_t code) const{
+	// Returns value in: 0.1 C
+
+	if(code >= 1024){
+		return table[BQ25672_NTC_TABLE_SIZE - 1];
+	}
+
+	uint16_t index = code >> BQ25672_NTC_TABLE_SHIFT;
+	int32_t fraction = code & ((1 << BQ25672_NTC_TABLE_SHIFT) - 1);
+	int32_t step = table[index + 1] - table[index];
+
+	return table[index] + ((step * fraction) >> BQ25672_NTC_TABLE_SHIFT);
+}
+
+float BQ25672NtcConverter::toCelsius(float percentage) const{
+	// Returns value in: C
+
+	if(percentage < 0) percentage = 0;
+	if(percentage > 100) percentage = 100;
+
+	uint16_t code = (uint16_t)(percentage * 10.24 + 0.5);
+	return toDeciCelsius(code) * 0.1;
+}
@@ -0,0 +1,37 @@
+/*
+  FILE:    BQ25672NtcConverter.h
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Converts the BQ25672 TS reading to a temperature with a lookup table
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#ifndef BQ25672_NTC_CONVERTER_H_
+#define BQ25672_NTC_CONVERTER_H_
+
+#include <Arduino.h>
+
+// The TS ADC returns 0..1024 LSB for 0..100% of REGN. The table holds one
+// temperature every (1 << BQ25672_NTC_TABLE_SHIFT) LSB.
+#define BQ25672_NTC_TABLE_SHIFT 3
+#define BQ25672_NTC_TABLE_SIZE ((1024 >> BQ25672_NTC_TABLE_SHIFT) + 1)
+
+class BQ25672NtcConverter {
+public:
+	// Defaults match the datasheet reference design:
+	// 10k NTC with beta 3435, RT1 (REGN to TS) = 5.24k, RT2 (TS to GND) = 30.31k
+	BQ25672NtcConverter();
+	BQ25672NtcConverter(float beta, float r25, float rt1, float rt2);
+
+	void setParameters(float beta, float r25, float rt1, float rt2);
+
+	int toDeciCelsius(uint16_t code) const;	// code = BQ25672::getNtcReadingCode()
+	float toCelsius(float percentage) const;	// percentage = BQ25672::getNtcReading()
+
+private:
+	int16_t table[BQ25672_NTC_TABLE_SIZE];
+
+	void buildTable(float beta, float r25, float rt1, float rt2);
+};
+#endif /* BQ25672_NTC_CONVERTER_H_ */
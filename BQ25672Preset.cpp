@@ -0,0 +1,36 @@
+/*
+  FILE:    BQ25672Preset.cpp
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Chemistry and cell count presets as compile time register images
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#include "BQ25672Preset.h"
+
+bool BQ25672Preset::apply(BQ25672 *charger) const{
+	if(!isValid()) return false;
+
+	const BQ25672PresetImage image = getImage();
+	uint8_t data[BQ25672_PRESET_SIZE];
+
+	if(!charger->readRegisters(BQ25672_PRESET_FIRST_REGISTER, data, BQ25672_PRESET_SIZE)) return false;
+
+	for(int i = 0; i < BQ25672_PRESET_SIZE; i++){
+		data[i] = (data[i] & ~image.mask[i]) | (image.data[i] & image.mask[i]);
+	}
+	return charger->writeRegisters(BQ25672_PRESET_FIRST_REGISTER, data, BQ25672_PRESET_SIZE);
+}
+
+bool BQ25672Preset::mergeInto(BQ25672RegisterImage *register_image) const{
+	if(!isValid()) return false;
+
+	const BQ25672PresetImage image = getImage();
+
+	for(int i = 0; i < BQ25672_PRESET_SIZE; i++){
+		uint8_t reg = BQ25672_PRESET_FIRST_REGISTER + i;
+		register_image->set(reg, (register_image->get(reg) & ~image.mask[i]) | (image.data[i] & image.mask[i]));
+	}
+	return true;
+}
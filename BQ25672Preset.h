@@ -0,0 +1,168 @@
+/*
+  FILE:    BQ25672Preset.h
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Chemistry and cell count presets as compile time register images
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#ifndef BQ25672_PRESET_H_
+#define BQ25672_PRESET_H_
+
+#include "BQ25672.h"
+#include "BQ25672RegisterImage.h"
+
+// A preset covers REG01 (VREG) up to REG0A (CELL, VRECHG)
+#define BQ25672_PRESET_FIRST_REGISTER 0x01
+#define BQ25672_PRESET_SIZE 10
+
+// Datasheet limits
+#define BQ25672_PRESET_CELL_VOLTAGE_MIN 3000  // mV
+#define BQ25672_PRESET_CHARGE_VOLTAGE_MIN 3000  // mV
+#define BQ25672_PRESET_CHARGE_VOLTAGE_MAX 18800  // mV
+#define BQ25672_PRESET_CHARGE_CURRENT_MIN 50  // mA
+#define BQ25672_PRESET_CHARGE_CURRENT_MAX 5000  // mA
+#define BQ25672_PRESET_PRE_CHARGE_CURRENT_MIN 40  // mA
+#define BQ25672_PRESET_PRE_CHARGE_CURRENT_MAX 2000  // mA
+#define BQ25672_PRESET_TERMINATION_CURRENT_MIN 40  // mA
+#define BQ25672_PRESET_TERMINATION_CURRENT_MAX 1000  // mA
+#define BQ25672_PRESET_RECHARGE_OFFSET_MIN 50  // mV
+#define BQ25672_PRESET_RECHARGE_OFFSET_MAX 800  // mV
+
+// Fails the build when a preset is outside the datasheet limits
+#define BQ25672_PRESET_CHECK(preset) static_assert((preset).isValid(), "BQ25672 preset outside the datasheet limits")
+
+struct BQ25672PresetImage {
+	uint8_t data[BQ25672_PRESET_SIZE];
+	uint8_t mask[BQ25672_PRESET_SIZE];  // Bits set by the preset, the rest keeps its value
+};
+
+// Everything is constexpr, so presets and overrides like
+//   constexpr BQ25672Preset my_preset = BQ25672_PRESET_LI_ION_2S.withChargeCurrent(2000);
+// compile to a constant register image. A value of 0 leaves the field unchanged.
+class BQ25672Preset {
+public:
+	constexpr BQ25672Preset(uint8_t cells, uint16_t cell_voltage, uint16_t charge_current,
+			uint16_t pre_charge_current, uint16_t termination_current, uint16_t recharge_offset):
+		cells(cells), cell_voltage(cell_voltage), charge_current(charge_current),
+		pre_charge_current(pre_charge_current), termination_current(termination_current), recharge_offset(recharge_offset) {}
+
+	static constexpr BQ25672Preset liIon(uint8_t cells){
+		return BQ25672Preset(cells, 4200, 0, 120, 200, 100 * cells);
+	}
+	static constexpr BQ25672Preset liFePO4(uint8_t cells){
+		return BQ25672Preset(cells, 3600, 0, 120, 120, 100 * cells);
+	}
+	static constexpr BQ25672Preset liIonStorage(uint8_t cells){
+		// Charges to about 60 %, for batteries that stay on the charger
+		return BQ25672Preset(cells, 3850, 0, 120, 200, 100 * cells);
+	}
+
+	constexpr BQ25672Preset withCellVoltage(uint16_t value) const{
+		return BQ25672Preset(cells, value, charge_current, pre_charge_current, termination_current, recharge_offset);
+	}
+	constexpr BQ25672Preset withChargeCurrent(uint16_t value) const{
+		return BQ25672Preset(cells, cell_voltage, value, pre_charge_current, termination_current, recharge_offset);
+	}
+	constexpr BQ25672Preset withPreChargeCurrent(uint16_t value) const{
+		return BQ25672Preset(cells, cell_voltage, charge_current, value, termination_current, recharge_offset);
+	}
+	constexpr BQ25672Preset withTerminationCurrent(uint16_t value) const{
+		return BQ25672Preset(cells, cell_voltage, charge_current, pre_charge_current, value, recharge_offset);
+	}
+	constexpr BQ25672Preset withRechargeOffset(uint16_t value) const{
+		return BQ25672Preset(cells, cell_voltage, charge_current, pre_charge_current, termination_current, value);
+	}
+
+	constexpr uint16_t getChargeVoltage() const{
+		// Returns value in: mV
+		return cells * cell_voltage;
+	}
+
+	constexpr bool isValid() const{
+		return cells >= 1 && cells <= 4
+			&& (cell_voltage == 0 || cell_voltage >= BQ25672_PRESET_CELL_VOLTAGE_MIN)
+			&& inRange(getChargeVoltage(), BQ25672_PRESET_CHARGE_VOLTAGE_MIN, BQ25672_PRESET_CHARGE_VOLTAGE_MAX)
+			&& inRange(charge_current, BQ25672_PRESET_CHARGE_CURRENT_MIN, BQ25672_PRESET_CHARGE_CURRENT_MAX)
+			&& inRange(pre_charge_current, BQ25672_PRESET_PRE_CHARGE_CURRENT_MIN, BQ25672_PRESET_PRE_CHARGE_CURRENT_MAX)
+			&& inRange(termination_current, BQ25672_PRESET_TERMINATION_CURRENT_MIN, BQ25672_PRESET_TERMINATION_CURRENT_MAX)
+			&& inRange(recharge_offset, BQ25672_PRESET_RECHARGE_OFFSET_MIN, BQ25672_PRESET_RECHARGE_OFFSET_MAX);
+	}
+
+	constexpr BQ25672PresetImage getImage() const{
+		return BQ25672PresetImage{
+			{getByte(0), getByte(1), getByte(2), getByte(3), getByte(4), getByte(5), getByte(6), getByte(7), getByte(8), getByte(9)},
+			{getMask(0), getMask(1), getMask(2), getMask(3), getMask(4), getMask(5), getMask(6), getMask(7), getMask(8), getMask(9)}
+		};
+	}
+
+	constexpr uint8_t getByte(uint8_t index) const{
+		// index 0 = REG01
+		return index == 0 ? (uint8_t)(((getChargeVoltage() / 10) >> 8) & 0x07)
+			: index == 1 ? (uint8_t)((getChargeVoltage() / 10) & 0xFF)
+			: index == 2 ? (uint8_t)(((charge_current / 10) >> 8) & 0x01)
+			: index == 3 ? (uint8_t)((charge_current / 10) & 0xFF)
+			: index == 7 ? (uint8_t)((pre_charge_current / 40) & 0x3F)
+			: index == 8 ? (uint8_t)((termination_current / 40) & 0x1F)
+			: index == 9 ? (uint8_t)(((cells - 1) << 6) | (recharge_offset > 0 ? ((recharge_offset - 50) / 50) & 0x0F : 0))
+			: 0;
+	}
+
+	constexpr uint8_t getMask(uint8_t index) const{
+		return index == 0 ? (cell_voltage > 0 ? 0x07 : 0)
+			: index == 1 ? (cell_voltage > 0 ? 0xFF : 0)
+			: index == 2 ? (charge_current > 0 ? 0x01 : 0)
+			: index == 3 ? (charge_current > 0 ? 0xFF : 0)
+			: index == 7 ? (pre_charge_current > 0 ? 0x3F : 0)
+			: index == 8 ? (termination_current > 0 ? 0x1F : 0)
+			: index == 9 ? (uint8_t)(0xC0 | (recharge_offset > 0 ? 0x0F : 0))
+			: 0;
+	}
+
+	// Reads REG01..REG0A in one burst, merges the preset and writes them back in one burst.
+	// VINDPM and IINDPM in between are written with the value just read.
+	// Both refuse a preset that is not valid, the fields would be truncated otherwise.
+	bool apply(BQ25672 *charger) const;
+	bool mergeInto(BQ25672RegisterImage *image) const;  // E.g. the image of a BQ25672ConfigGuard
+
+	uint8_t cells;
+	uint16_t cell_voltage;  // mV
+	uint16_t charge_current;  // mA
+	uint16_t pre_charge_current;  // mA
+	uint16_t termination_current;  // mA
+	uint16_t recharge_offset;  // mV below the charge voltage
+
+private:
+	static constexpr bool inRange(uint16_t value, uint16_t min, uint16_t max){
+		// 0 leaves the field unchanged and is always valid
+		return value == 0 || (value >= min && value <= max);
+	}
+};
+
+constexpr BQ25672Preset BQ25672_PRESET_LI_ION_1S = BQ25672Preset::liIon(1);
+constexpr BQ25672Preset BQ25672_PRESET_LI_ION_2S = BQ25672Preset::liIon(2);
+constexpr BQ25672Preset BQ25672_PRESET_LI_ION_3S = BQ25672Preset::liIon(3);
+constexpr BQ25672Preset BQ25672_PRESET_LI_ION_4S = BQ25672Preset::liIon(4);
+constexpr BQ25672Preset BQ25672_PRESET_LIFEPO4_1S = BQ25672Preset::liFePO4(1);
+constexpr BQ25672Preset BQ25672_PRESET_LIFEPO4_2S = BQ25672Preset::liFePO4(2);
+constexpr BQ25672Preset BQ25672_PRESET_LIFEPO4_3S = BQ25672Preset::liFePO4(3);
+constexpr BQ25672Preset BQ25672_PRESET_LIFEPO4_4S = BQ25672Preset::liFePO4(4);
+constexpr BQ25672Preset BQ25672_PRESET_STORAGE_1S = BQ25672Preset::liIonStorage(1);
+constexpr BQ25672Preset BQ25672_PRESET_STORAGE_2S = BQ25672Preset::liIonStorage(2);
+constexpr BQ25672Preset BQ25672_PRESET_STORAGE_3S = BQ25672Preset::liIonStorage(3);
+constexpr BQ25672Preset BQ25672_PRESET_STORAGE_4S = BQ25672Preset::liIonStorage(4);
+
+BQ25672_PRESET_CHECK(BQ25672_PRESET_LI_ION_1S);
+BQ25672_PRESET_CHECK(BQ25672_PRESET_LI_ION_2S);
+BQ25672_PRESET_CHECK(BQ25672_PRESET_LI_ION_3S);
+BQ25672_PRESET_CHECK(BQ25672_PRESET_LI_ION_4S);
+BQ25672_PRESET_CHECK(BQ25672_PRESET_LIFEPO4_1S);
+BQ25672_PRESET_CHECK(BQ25672_PRESET_LIFEPO4_2S);
+BQ25672_PRESET_CHECK(BQ25672_PRESET_LIFEPO4_3S);
+BQ25672_PRESET_CHECK(BQ25672_PRESET_LIFEPO4_4S);
+BQ25672_PRESET_CHECK(BQ25672_PRESET_STORAGE_1S);
+BQ25672_PRESET_CHECK(BQ25672_PRESET_STORAGE_2S);
+BQ25672_PRESET_CHECK(BQ25672_PRESET_STORAGE_3S);
+BQ25672_PRESET_CHECK(BQ25672_PRESET_STORAGE_4S);
+#endif /* BQ25672_PRESET_H_ */
@@ -0,0 +1,123 @@
+/*
+  FILE:    BQ25672RegisterImage.cpp
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Copy of the BQ25672 configuration registers
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#include "BQ25672RegisterImage.h"
+
+static const uint8_t block_start[BQ25672_IMAGE_BLOCK_COUNT] = {0x00, 0x28};
+static const uint8_t block_size[BQ25672_IMAGE_BLOCK_COUNT] = {25, 9};
+
+BQ25672RegisterImage::BQ25672RegisterImage(){
+	memset(data, 0, sizeof(data));
+}
+
+bool BQ25672RegisterImage::read(BQ25672 *charger){
+	uint8_t index = 0;
+	for(int i = 0; i < BQ25672_IMAGE_BLOCK_COUNT; i++){
+		if(!charger->readRegisters(block_start[i], data + index, block_size[i])) return false;
+		index += block_size[i];
+	}
+	return true;
+}
+
+bool BQ25672RegisterImage::write(BQ25672 *charger) const{
+	uint8_t out[BQ25672_IMAGE_SIZE];
+	for(int i = 0; i < BQ25672_IMAGE_SIZE; i++){
+		out[i] = data[i] & ~getVolatileMask(registerAt(i));
+	}
+
+	uint8_t index = 0;
+	for(int i = 0; i < BQ25672_IMAGE_BLOCK_COUNT; i++){
+		if(!charger->writeRegisters(block_start[i], out + index, block_size[i])) return false;
+		index += block_size[i];
+	}
+	return true;
+}
+
+uint8_t BQ25672RegisterImage::get(uint8_t reg) const{
+	int index = indexOf(reg);
+	return index < 0 ? 0 : data[index];
+}
+
+bool BQ25672RegisterImage::set(uint8_t reg, uint8_t value){
+	int index = indexOf(reg);
+	if(index < 0) return false;
+
+	data[index] = value;
+	return true;
+}
+
+uint16_t BQ25672RegisterImage::getField(uint8_t reg, uint8_t byte_cnt, uint8_t bit_start, uint8_t bit_end) const{
+	uint16_t value = get(reg);
+	if(byte_cnt == 2) value = (value << 8) | get(reg + 1);
+
+	uint16_t bit_mask = (0xFFFF >> (16 - (bit_end - bit_start + 1))) << bit_start;
+	return (value & bit_mask) >> bit_start;
+}
+
+bool BQ25672RegisterImage::setField(uint8_t reg, uint8_t byte_cnt, uint8_t bit_start, uint8_t bit_end, uint16_t value){
+	if(value >= (1UL << (bit_end - bit_start + 1))){
+		// Data is out of range
+		return false;
+	}
+	if(indexOf(reg) < 0 || (byte_cnt == 2 && indexOf(reg + 1) < 0)) return false;
+
+	uint16_t bit_mask = (0xFFFF >> (16 - (bit_end - bit_start + 1))) << bit_start;
+	uint16_t old_value = get(reg);
+	if(byte_cnt == 2) old_value = (old_value << 8) | get(reg + 1);
+
+	uint16_t new_value = (old_value & ~bit_mask) | (value << bit_start);
+	if(byte_cnt == 2){
+		set(reg, new_value >> 8);
+		set(reg + 1, new_value & 0xFF);
+	}
+	else{
+		set(reg, new_value & 0xFF);
+	}
+	return true;
+}
+
+bool BQ25672RegisterImage::equals(const BQ25672RegisterImage *other) const{
+	for(int i = 0; i < BQ25672_IMAGE_SIZE; i++){
+		uint8_t mask = ~getVolatileMask(registerAt(i));
+		if((data[i] & mask) != (other->data[i] & mask)) return false;
+	}
+	return true;
+}
+
+int BQ25672RegisterImage::indexOf(uint8_t reg){
+	uint8_t index = 0;
+	for(int i = 0; i < BQ25672_IMAGE_BLOCK_COUNT; i++){
+		if(reg >= block_start[i] && reg < block_start[i] + block_size[i]){
+			return index + reg - block_start[i];
+		}
+		index += block_size[i];
+	}
+	return -1;
+}
+
+uint8_t BQ25672RegisterImage::registerAt(uint8_t index){
+	for(int i = 0; i < BQ25672_IMAGE_BLOCK_COUNT; i++){
+		if(index < block_size[i]) return block_start[i] + index;
+		index -= block_size[i];
+	}
+	return 0xFF;
+}
+
+uint8_t BQ25672RegisterImage::getVolatileMask(uint8_t reg){
+	// Bits that trigger an action instead of holding a setting must not be replayed
+	switch(reg){
+		case 0x09: return 0x40;  // REG_RST
+		case 0x0F: return 0x08;  // FORCE_ICO
+		case 0x10: return 0x08;  // WD_RST
+		case 0x11: return 0x86;  // FORCE_INDET, SDRV_CTRL (shutdown and ship mode)
+		case 0x13: return 0x02;  // FORCE_VINDPM_DET
+		case 0x16: return 0x01;  // BKUP_ACFET1_ON
+		default: return 0x00;
+	}
+}
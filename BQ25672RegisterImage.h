@@ -0,0 +1,42 @@
+/*
+  FILE:    BQ25672RegisterImage.h
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Copy of the BQ25672 configuration registers
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#ifndef BQ25672_REGISTER_IMAGE_H_
+#define BQ25672_REGISTER_IMAGE_H_
+
+#include "BQ25672.h"
+
+// The writable configuration lives in two contiguous blocks:
+// REG00..REG18 (charger settings) and REG28..REG30 (masks and ADC control)
+#define BQ25672_IMAGE_BLOCK_COUNT 2
+#define BQ25672_IMAGE_SIZE (25 + 9)
+
+class BQ25672RegisterImage {
+public:
+	BQ25672RegisterImage();
+
+	bool read(BQ25672 *charger);  // One burst per block
+	bool write(BQ25672 *charger) const;  // One burst per block, self-clearing bits are written as 0
+
+	uint8_t get(uint8_t reg) const;
+	bool set(uint8_t reg, uint8_t value);  // false if reg is not part of the image
+
+	// Same arguments as the register accessors of BQ25672, multi-byte registers are MSB first
+	uint16_t getField(uint8_t reg, uint8_t byte_cnt, uint8_t bit_start, uint8_t bit_end) const;
+	bool setField(uint8_t reg, uint8_t byte_cnt, uint8_t bit_start, uint8_t bit_end, uint16_t value);
+
+	bool equals(const BQ25672RegisterImage *other) const;  // Ignores self-clearing bits
+
+	static int indexOf(uint8_t reg);  // -1 if reg is not part of the image
+	static uint8_t registerAt(uint8_t index);
+	static uint8_t getVolatileMask(uint8_t reg);  // Self-clearing and one-shot bits
+
+	uint8_t data[BQ25672_IMAGE_SIZE];
+};
+#endif /* BQ25672_REGISTER_IMAGE_H_ */
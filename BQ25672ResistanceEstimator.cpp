@@ -0,0 +1,165 @@
+/*
+  FILE:    BQ25672ResistanceEstimator.cpp
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Battery internal resistance from steps in the BQ25672 battery current
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#include "BQ25672ResistanceEstimator.h"
+
+#define OUTLIER_MIN_SAMPLES 4  // Below this every plausible sample is accepted
+#define OUTLIER_MADS 3
+#define OUTLIER_FLOOR 5  // mOhm, so identical samples do not reject everything else
+
+BQ25672ResistanceEstimator::BQ25672ResistanceEstimator(BQ25672 *charger):
+	_charger(charger), _arbiter(NULL), min_step(200), max_interval(2000), min_resistance(5), max_resistance(2000),
+	history_interval(86400000UL), has_last(false), last_voltage(0), last_current(0), last_timestamp(0),
+	sample_fill(0), sample_next(0), outlier_run(0), last_sample(0), resistance(0), sample_count(0), rejected_count(0),
+	history_fill(0), history_next(0) {
+}
+
+void BQ25672ResistanceEstimator::setLimitArbiter(BQ25672LimitArbiter *arbiter){
+	_arbiter = arbiter;
+}
+
+void BQ25672ResistanceEstimator::setStepDetection(int new_min_step, uint32_t new_max_interval){
+	min_step = new_min_step;
+	max_interval = new_max_interval;
+}
+
+void BQ25672ResistanceEstimator::setLimits(int new_min_resistance, int new_max_resistance){
+	min_resistance = new_min_resistance;
+	max_resistance = new_max_resistance;
+}
+
+void BQ25672ResistanceEstimator::setHistoryInterval(uint32_t new_history_interval){
+	history_interval = new_history_interval;
+}
+
+bool BQ25672ResistanceEstimator::induceStep(int charge_current){
+	// The last snapshot before the write is the "before" sample
+	if(_arbiter != NULL) return _arbiter->request(BQ25672_LIMIT_CHARGE_CURRENT, BQ25672_LIMIT_CLIENT_RESISTANCE_ESTIMATOR, charge_current);
+	if(_charger == NULL) return false;
+	return _charger->setChargeCurrent(charge_current);
+}
+
+bool BQ25672ResistanceEstimator::endStep(){
+	if(_arbiter == NULL) return true;
+	return _arbiter->release(BQ25672_LIMIT_CHARGE_CURRENT, BQ25672_LIMIT_CLIENT_RESISTANCE_ESTIMATOR);
+}
+
+bool BQ25672ResistanceEstimator::process(const BQ25672AdcSnapshot *adc){
+	bool accepted = false;
+
+	if(has_last && adc->timestamp - last_timestamp <= max_interval){
+		int32_t delta_current = (int32_t) adc->battery_current - last_current;
+		int32_t delta_voltage = (int32_t) adc->battery_voltage - last_voltage;
+
+		if(delta_current >= min_step || delta_current <= -min_step){
+			last_sample = delta_voltage * 1000 / delta_current;
+			accepted = accept(last_sample);
+		}
+	}
+
+	has_last = true;
+	last_voltage = adc->battery_voltage;
+	last_current = adc->battery_current;
+	last_timestamp = adc->timestamp;
+
+	// Store the estimate once per history interval
+	if(resistance != 0){
+		uint8_t newest = (history_next + BQ25672_RESISTANCE_HISTORY - 1) % BQ25672_RESISTANCE_HISTORY;
+		if(history_fill == 0 || adc->timestamp - history_time[newest] >= history_interval){
+			history[history_next] = resistance;
+			history_time[history_next] = adc->timestamp;
+			history_next = (history_next + 1) % BQ25672_RESISTANCE_HISTORY;
+			if(history_fill < BQ25672_RESISTANCE_HISTORY) history_fill++;
+		}
+	}
+	return accepted;
+}
+
+int BQ25672ResistanceEstimator::getResistance(){
+	// Returns value in: mOhm
+	return resistance;
+}
+
+int BQ25672ResistanceEstimator::getLastSample(){
+	// Returns value in: mOhm
+	return last_sample;
+}
+
+uint32_t BQ25672ResistanceEstimator::getSampleCount(){
+	return sample_count;
+}
+
+uint32_t BQ25672ResistanceEstimator::getRejectedCount(){
+	return rejected_count;
+}
+
+uint8_t BQ25672ResistanceEstimator::getHistoryCount(){
+	return history_fill;
+}
+
+int BQ25672ResistanceEstimator::getHistory(uint8_t index, uint32_t *timestamp){
+	// Returns value in: mOhm, 0 if not available
+	if(index >= history_fill) return 0;
+
+	uint8_t i = (history_next + BQ25672_RESISTANCE_HISTORY - 1 - index) % BQ25672_RESISTANCE_HISTORY;
+	if(timestamp != NULL) *timestamp = history_time[i];
+	return history[i];
+}
+
+bool BQ25672ResistanceEstimator::accept(int sample){
+	if(sample < min_resistance || sample > max_resistance){
+		rejected_count++;
+		return false;
+	}
+
+	if(sample_fill >= OUTLIER_MIN_SAMPLES){
+		int16_t deviations[BQ25672_RESISTANCE_SAMPLES];
+		for(int i = 0; i < sample_fill; i++){
+			deviations[i] = abs(samples[i] - resistance);
+		}
+		int limit = OUTLIER_MADS * median(deviations, sample_fill) + OUTLIER_FLOOR;
+
+		if(abs(sample - resistance) > limit){
+			rejected_count++;
+
+			// A full window of outliers in a row is a real change, e.g. of the temperature: start over
+			if(++outlier_run >= BQ25672_RESISTANCE_SAMPLES){
+				sample_fill = 0;
+				sample_next = 0;
+				outlier_run = 0;
+			}
+			return false;
+		}
+	}
+	outlier_run = 0;
+
+	samples[sample_next] = sample;
+	sample_next = (sample_next + 1) % BQ25672_RESISTANCE_SAMPLES;
+	if(sample_fill < BQ25672_RESISTANCE_SAMPLES) sample_fill++;
+	sample_count++;
+	resistance = median(samples, sample_fill);
+	return true;
+}
+
+int BQ25672ResistanceEstimator::median(const int16_t *values, uint8_t count){
+	// Insertion sort of a copy, count <= BQ25672_RESISTANCE_SAMPLES
+	int16_t sorted[BQ25672_RESISTANCE_SAMPLES];
+	for(int i = 0; i < count; i++){
+		int16_t value = values[i];
+		int j = i;
+		while(j > 0 && sorted[j - 1] > value){
+			sorted[j] = sorted[j - 1];
+			j--;
+		}
+		sorted[j] = value;
+	}
+	if(count == 0) return 0;
+	if(count % 2) return sorted[count / 2];
+	return (sorted[count / 2 - 1] + sorted[count / 2]) / 2;
+}
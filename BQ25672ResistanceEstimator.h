@@ -0,0 +1,80 @@
+/*
+  FILE:    BQ25672ResistanceEstimator.h
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Battery internal resistance from steps in the BQ25672 battery current
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#ifndef BQ25672_RESISTANCE_ESTIMATOR_H_
+#define BQ25672_RESISTANCE_ESTIMATOR_H_
+
+#include "BQ25672.h"
+#include "BQ25672LimitArbiter.h"
+
+// Accepted samples the estimate is the median of
+#ifndef BQ25672_RESISTANCE_SAMPLES
+#define BQ25672_RESISTANCE_SAMPLES 8
+#endif
+
+// Stored estimates, one per history interval
+#ifndef BQ25672_RESISTANCE_HISTORY
+#define BQ25672_RESISTANCE_HISTORY 8
+#endif
+
+// R = dVBAT / dIBAT between two consecutive snapshots with a large enough
+// current step, from load changes or from induceStep(). Samples further
+// than 3 median absolute deviations from the median are rejected.
+class BQ25672ResistanceEstimator {
+public:
+	BQ25672ResistanceEstimator(BQ25672 *charger = NULL);  // Only needed for induceStep()
+	void setLimitArbiter(BQ25672LimitArbiter *arbiter);  // NULL = write the registers directly
+
+	void setStepDetection(int min_step, uint32_t max_interval);  // mA, ms between the two snapshots
+	void setLimits(int min_resistance, int max_resistance);  // mOhm, plausible range
+	void setHistoryInterval(uint32_t history_interval);  // ms
+
+	bool induceStep(int charge_current);  // Writes the charge current, the next snapshot measures the step
+	bool endStep();  // With an arbiter: releases the charge current request of induceStep()
+	bool process(const BQ25672AdcSnapshot *adc);  // Returns true when a sample was accepted
+
+	int getResistance();  // mOhm, 0 until the first sample
+	int getLastSample();  // mOhm, also when rejected
+	uint32_t getSampleCount();
+	uint32_t getRejectedCount();
+	uint8_t getHistoryCount();
+	int getHistory(uint8_t index, uint32_t *timestamp = NULL);  // 0 = most recent, mOhm
+
+private:
+	BQ25672 *_charger;
+	BQ25672LimitArbiter *_arbiter;
+	int min_step;
+	uint32_t max_interval;
+	int min_resistance;
+	int max_resistance;
+	uint32_t history_interval;
+
+	bool has_last;
+	uint16_t last_voltage;
+	int16_t last_current;
+	uint32_t last_timestamp;
+
+	int16_t samples[BQ25672_RESISTANCE_SAMPLES];
+	uint8_t sample_fill;
+	uint8_t sample_next;
+	uint8_t outlier_run;
+	int last_sample;
+	int resistance;
+	uint32_t sample_count;
+	uint32_t rejected_count;
+
+	int16_t history[BQ25672_RESISTANCE_HISTORY];
+	uint32_t history_time[BQ25672_RESISTANCE_HISTORY];
+	uint8_t history_fill;
+	uint8_t history_next;
+
+	bool accept(int sample);
+	static int median(const int16_t *values, uint8_t count);
+};
+#endif /* BQ25672_RESISTANCE_ESTIMATOR_H_ */
@@ -0,0 +1,173 @@
+/*
+  FILE:    BQ25672SocEstimator.cpp
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Battery state of charge from OCV and coulomb counting
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#include "BQ25672SocEstimator.h"
+
+#define CHARGE_STATUS_DONE 7
+#define SOC_FULL 1000  // 0.1 %
+#define VARIANCE_MAX 1000000L  // (0.1 %)^2
+#define VARIANCE_INITIAL 40000L  // 20 %, OCV read while the battery may be loaded
+#define VARIANCE_FULL 25L  // 0.5 %, right after charge done
+#define GAIN_ONE 32768L  // Q15
+
+// Per cell OCV in mV at 0%, 10%, ... 100%
+static const uint16_t li_ion_ocv[BQ25672_OCV_TABLE_SIZE] = {3300, 3590, 3670, 3720, 3760, 3800, 3860, 3930, 4000, 4080, 4180};
+static const uint16_t lifepo4_ocv[BQ25672_OCV_TABLE_SIZE] = {2800, 3000, 3200, 3250, 3270, 3285, 3300, 3310, 3330, 3350, 3400};
+
+BQ25672SocEstimator::BQ25672SocEstimator(BQ25672CoulombCounter *counter, uint8_t chemistry):
+	_counter(counter), cells(1), capacity_uah(1000000L), rest_current(20), rest_time(600000UL),
+	initialized(false), remaining(0), variance(VARIANCE_MAX), last_net_charge(0), moved_charge(0),
+	last_correction(0), at_rest(false) {
+	if(chemistry == BQ25672_CHEMISTRY_LIFEPO4){
+		ocv_table = lifepo4_ocv;
+		measurement_noise = 10000;  // 10 %, the curve is flat
+	}
+	else{
+		ocv_table = li_ion_ocv;
+		measurement_noise = 400;  // 2 %
+	}
+}
+
+bool BQ25672SocEstimator::begin(BQ25672 *charger, uint32_t capacity){
+	int cell_count = charger->getBatterySeriesCount();
+	if(cell_count < 1 || cell_count > 4) return false;
+
+	begin(cell_count, capacity);
+	return true;
+}
+
+void BQ25672SocEstimator::begin(uint8_t cell_count, uint32_t capacity){
+	cells = cell_count > 0 ? cell_count : 1;
+	capacity_uah = capacity > 0 ? capacity * 1000 : 1000;
+	initialized = false;
+}
+
+void BQ25672SocEstimator::setOcvTable(const uint16_t *table, uint32_t noise){
+	ocv_table = table;
+	measurement_noise = noise;
+}
+
+void BQ25672SocEstimator::setRestDetection(int16_t new_rest_current, uint32_t new_rest_time){
+	rest_current = new_rest_current;
+	rest_time = new_rest_time;
+}
+
+void BQ25672SocEstimator::update(const BQ25672AdcSnapshot *adc, const BQ25672StatusSnapshot *status){
+	uint32_t now = adc->timestamp;
+	int32_t net_charge = _counter->getNetCharge();
+
+	if(!initialized){
+		if(adc->battery_voltage == 0) return;
+
+		remaining = (int64_t) ocvToSoc(ocv_table, adc->battery_voltage / cells) * capacity_uah / SOC_FULL;
+		variance = VARIANCE_INITIAL;
+		last_net_charge = net_charge;
+		moved_charge = 0;
+		at_rest = false;
+		initialized = true;
+		return;
+	}
+
+	// Predict with the coulomb counter
+	int32_t delta = net_charge - last_net_charge;
+	last_net_charge = net_charge;
+	remaining += delta;
+	if(remaining < 0) remaining = 0;
+	if(remaining > capacity_uah) remaining = capacity_uah;
+
+	// The uncertainty grows by 1 (0.1 %)^2 per 0.1 % of charge moved
+	moved_charge += delta < 0 ? -delta : delta;
+	int32_t moved_permille = (int64_t) moved_charge * SOC_FULL / capacity_uah;
+	moved_charge -= (int64_t) moved_permille * capacity_uah / SOC_FULL;
+	variance += moved_permille;
+	if(variance > VARIANCE_MAX) variance = VARIANCE_MAX;
+
+	if(status != NULL && BQ25672::getStatusField(status, BQ25672_STATUS_CHARGE_STATUS) == CHARGE_STATUS_DONE){
+		remaining = capacity_uah;
+		variance = VARIANCE_FULL;
+		at_rest = false;
+		return;
+	}
+
+	// Correct with the OCV once per rest_time while the battery is at rest
+	int16_t current = adc->battery_current;
+	if(current > rest_current || current < -rest_current){
+		at_rest = false;
+		return;
+	}
+
+	if(!at_rest){
+		at_rest = true;
+		last_correction = now;
+	}
+	else if(now - last_correction >= rest_time){
+		correct(ocvToSoc(ocv_table, adc->battery_voltage / cells), measurement_noise);
+		last_correction = now;
+	}
+}
+
+uint16_t BQ25672SocEstimator::getSoc(){
+	// Returns value in: 0.1 %
+	return (int64_t) remaining * SOC_FULL / capacity_uah;
+}
+
+uint8_t BQ25672SocEstimator::getSocPercent(){
+	// Returns value in: %
+	return (getSoc() + 5) / 10;
+}
+
+uint16_t BQ25672SocEstimator::getUncertainty(){
+	// Returns value in: 0.1 %
+	// Integer square root, variance <= 10^6 so 11 iterations
+	uint32_t root = 0;
+	uint32_t value = variance;
+	for(uint32_t bit = 1UL << 20; bit != 0; bit >>= 2){
+		if(value >= root + bit){
+			value -= root + bit;
+			root = (root >> 1) + bit;
+		}
+		else{
+			root >>= 1;
+		}
+	}
+	return root;
+}
+
+int32_t BQ25672SocEstimator::getRemainingCharge(){
+	return remaining;
+}
+
+int32_t BQ25672SocEstimator::getCapacity(){
+	return capacity_uah;
+}
+
+bool BQ25672SocEstimator::isAtRest(){
+	return at_rest;
+}
+
+uint16_t BQ25672SocEstimator::ocvToSoc(const uint16_t *table, uint16_t cell_voltage){
+	// Returns value in: 0.1 %
+	if(cell_voltage <= table[0]) return 0;
+	if(cell_voltage >= table[BQ25672_OCV_TABLE_SIZE - 1]) return SOC_FULL;
+
+	uint8_t i = 0;
+	while(cell_voltage >= table[i + 1]){
+		i++;
+	}
+	uint32_t step = SOC_FULL / (BQ25672_OCV_TABLE_SIZE - 1);
+	return i * step + (uint32_t)(cell_voltage - table[i]) * step / (table[i + 1] - table[i]);
+}
+
+void BQ25672SocEstimator::correct(int32_t measured_soc, int32_t noise){
+	int32_t gain = (int64_t) variance * GAIN_ONE / (variance + noise);
+	int32_t measured = (int64_t) measured_soc * capacity_uah / SOC_FULL;
+
+	remaining += ((int64_t)(measured - remaining) * gain) / GAIN_ONE;
+	variance = ((int64_t) variance * (GAIN_ONE - gain)) / GAIN_ONE;
+}
@@ -0,0 +1,67 @@
+/*
+  FILE:    BQ25672SocEstimator.h
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Battery state of charge from OCV and coulomb counting
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#ifndef BQ25672_SOC_ESTIMATOR_H_
+#define BQ25672_SOC_ESTIMATOR_H_
+
+#include "BQ25672.h"
+#include "BQ25672CoulombCounter.h"
+
+#define BQ25672_CHEMISTRY_LI_ION 0  // 4.2V per cell
+#define BQ25672_CHEMISTRY_LIFEPO4 1  // 3.6V per cell
+
+// OCV tables hold the cell voltage in mV at 0%, 10%, ... 100%
+#define BQ25672_OCV_TABLE_SIZE 11
+
+// One-state Kalman filter in fixed point: the coulomb counter predicts, the
+// OCV of a battery at rest corrects. The uncertainty grows with the charge
+// moved, a flat OCV curve (LiFePO4) gets a larger measurement noise.
+class BQ25672SocEstimator {
+public:
+	BQ25672SocEstimator(BQ25672CoulombCounter *counter, uint8_t chemistry = BQ25672_CHEMISTRY_LI_ION);
+
+	bool begin(BQ25672 *charger, uint32_t capacity);  // Capacity in mAh, reads the cell count
+	void begin(uint8_t cell_count, uint32_t capacity);
+
+	void setOcvTable(const uint16_t *table, uint32_t measurement_noise);  // Noise in (0.1%)^2
+	void setRestDetection(int16_t rest_current, uint32_t rest_time);  // mA, ms
+
+	// Call after BQ25672CoulombCounter::process() with the same snapshots
+	void update(const BQ25672AdcSnapshot *adc, const BQ25672StatusSnapshot *status = NULL);
+
+	uint16_t getSoc();  // 0.1 %
+	uint8_t getSocPercent();
+	uint16_t getUncertainty();  // 0.1 %, one standard deviation
+	int32_t getRemainingCharge();  // uAh
+	int32_t getCapacity();  // uAh
+	bool isAtRest();
+
+	static uint16_t ocvToSoc(const uint16_t *table, uint16_t cell_voltage);  // 0.1 %
+
+private:
+	BQ25672CoulombCounter *_counter;
+	const uint16_t *ocv_table;
+	uint32_t measurement_noise;
+
+	uint8_t cells;
+	int32_t capacity_uah;
+	int16_t rest_current;
+	uint32_t rest_time;
+
+	bool initialized;
+	int32_t remaining;  // uAh
+	int32_t variance;  // (0.1 %)^2
+	int32_t last_net_charge;  // uAh
+	int32_t moved_charge;  // uAh, not yet added to the variance
+	uint32_t last_correction;  // Start of the rest period or the last OCV correction
+	bool at_rest;
+
+	void correct(int32_t measured_soc, int32_t noise);
+};
+#endif /* BQ25672_SOC_ESTIMATOR_H_ */
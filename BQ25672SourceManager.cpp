@@ -0,0 +1,232 @@
+/*
+  FILE:    BQ25672SourceManager.cpp
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Input source detection and HVDCP negotiation for the BQ25672
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#include "BQ25672SourceManager.h"
+
+#define INDET_REGISTER 0x11
+#define FORCE_INDET_BIT 0x80
+#define EN_12V_BIT 0x20
+#define EN_9V_BIT 0x10
+#define HVDCP_EN_BIT 0x08
+
+// D+/D- DAC codes of REG47, HVDCP (QC2.0) voltage requests
+#define DPDM_REGISTER 0x47
+#define DPDM_HIZ 0
+#define DPDM_0V 1
+#define DPDM_0V6 2
+#define DPDM_3V3 6
+#define DPDM(dp, dm) (((dp) << 5) | ((dm) << 2))
+
+#define VERIFY_TOLERANCE 10  // %, VBUS below the requested voltage that still counts as reached
+
+// Input current limit in mA per VBUS_STAT code, 0 keeps the limit set by the charger
+static const int16_t default_current_limits[BQ25672_SOURCE_TYPE_COUNT] = {
+	0,  // No input
+	500,  // USB SDP
+	1500,  // USB CDP
+	3250,  // USB DCP
+	1500,  // HVDCP
+	3000,  // Unknown adapter
+	1000,  // Non standard adapter
+	0, 500, 0, 0, 0, 0, 0, 0, 0  // OTG, unqualified, reserved, direct from VBUS, backup
+};
+
+BQ25672SourceManager::BQ25672SourceManager(BQ25672 *charger):
+	_charger(charger), _arbiter(NULL), max_voltage(12000), detect_timeout(3000), verify_time(500),
+	state(BQ25672_SOURCE_IDLE), source_type(0), voltage(0), plug_time(0), state_time(0), settle_time(0),
+	forced(false), dpdm_driven(false), step_down_count(0), write_errors(0) {
+	for(int i = 0; i < BQ25672_SOURCE_TYPE_COUNT; i++) current_limits[i] = default_current_limits[i];
+}
+
+void BQ25672SourceManager::setLimitArbiter(BQ25672LimitArbiter *arbiter){
+	_arbiter = arbiter;
+}
+
+bool BQ25672SourceManager::begin(int new_max_voltage){
+	max_voltage = new_max_voltage;
+	return writeEnables(false);
+}
+
+void BQ25672SourceManager::setCurrentLimit(uint8_t type, int current){
+	if(type < BQ25672_SOURCE_TYPE_COUNT) current_limits[type] = current;
+}
+
+int BQ25672SourceManager::getCurrentLimit(uint8_t type){
+	// Returns value in: mA
+	if(type >= BQ25672_SOURCE_TYPE_COUNT) return 0;
+	return current_limits[type];
+}
+
+void BQ25672SourceManager::setTimeouts(uint32_t new_detect_timeout, uint32_t new_verify_time){
+	detect_timeout = new_detect_timeout;
+	verify_time = new_verify_time;
+}
+
+bool BQ25672SourceManager::process(BQ25672EventSet flags, const BQ25672StatusSnapshot *status){
+	uint32_t timestamp = status->timestamp;
+
+	if(!BQ25672::getStatusField(status, BQ25672_STATUS_VBUS_PRESENT)){
+		if(state == BQ25672_SOURCE_IDLE) return true;
+		enter(BQ25672_SOURCE_IDLE, timestamp);
+		source_type = 0;
+		voltage = 0;
+		bool released = _arbiter == NULL || _arbiter->release(BQ25672_LIMIT_INPUT_CURRENT, BQ25672_LIMIT_CLIENT_SOURCE_MANAGER);
+
+		// Release D+/D- so the next source starts from a clean detection
+		if(!dpdm_driven) return released;
+		uint8_t data = DPDM(DPDM_HIZ, DPDM_HIZ);
+		dpdm_driven = false;
+		if(_charger->writeRegisters(DPDM_REGISTER, &data, 1)) return released;
+		write_errors++;
+		return false;
+	}
+
+	if(state == BQ25672_SOURCE_IDLE){
+		plug_time = timestamp;
+		settle_time = 0;
+		forced = false;
+		enter(BQ25672_SOURCE_DETECTING, timestamp);
+
+		// Without a plug-in event the input was already there, e.g. at startup: detect again
+		if(flags & BQ25672_EVENT_BIT(BQ25672_EVENT_VBUS_PRESENT)) return true;
+		forced = true;
+		if(writeEnables(true)) return true;
+		return false;
+	}
+
+	BQ25672EventSet detection_events = BQ25672_EVENT_BIT(BQ25672_EVENT_BC12_DONE) | BQ25672_EVENT_BIT(BQ25672_EVENT_VBUS_STATUS);
+	if((flags & detection_events) && BQ25672::getStatusField(status, BQ25672_STATUS_BC12_DONE)){
+		uint8_t type = BQ25672::getStatusField(status, BQ25672_STATUS_VBUS_STATUS);
+		if(state == BQ25672_SOURCE_DETECTING || type != source_type){
+			source_type = type;
+			if(type == BQ25672_SOURCE_TYPE_HVDCP && max_voltage > 5000){
+				voltage = max_voltage >= 12000 ? 12000 : 9000;
+				enter(BQ25672_SOURCE_VERIFYING, timestamp);
+				return true;
+			}
+			voltage = 5000;
+			return ready(timestamp);
+		}
+	}
+
+	if((flags & BQ25672_EVENT_BIT(BQ25672_EVENT_POOR_SOURCE)) && state == BQ25672_SOURCE_READY && voltage > 5000){
+		return stepDown(timestamp);
+	}
+	return true;
+}
+
+bool BQ25672SourceManager::update(const BQ25672AdcSnapshot *adc){
+	uint32_t timestamp = adc->timestamp;
+
+	if(state == BQ25672_SOURCE_DETECTING && timestamp - state_time >= detect_timeout){
+		if(!forced){
+			forced = true;
+			state_time = timestamp;
+			if(_charger->ForceDpdnDetection()) return true;
+			write_errors++;
+			return false;
+		}
+
+		// No result after a forced detection either: continue at 5V
+		voltage = 5000;
+		return ready(timestamp);
+	}
+
+	if(state == BQ25672_SOURCE_VERIFYING){
+		if(adc->bus_voltage >= voltage - voltage * VERIFY_TOLERANCE / 100) return ready(timestamp);
+		if(timestamp - state_time >= verify_time) return stepDown(timestamp);
+	}
+	return true;
+}
+
+uint8_t BQ25672SourceManager::getState(){
+	return state;
+}
+
+uint8_t BQ25672SourceManager::getSourceType(){
+	return source_type;
+}
+
+int BQ25672SourceManager::getVoltage(){
+	// Returns value in: mV
+	return voltage;
+}
+
+uint32_t BQ25672SourceManager::getSettleTime(){
+	// Returns value in: ms
+	return settle_time;
+}
+
+uint32_t BQ25672SourceManager::getStepDownCount(){
+	return step_down_count;
+}
+
+uint32_t BQ25672SourceManager::getWriteErrorCount(){
+	return write_errors;
+}
+
+void BQ25672SourceManager::enter(uint8_t new_state, uint32_t timestamp){
+	state = new_state;
+	state_time = timestamp;
+}
+
+bool BQ25672SourceManager::ready(uint32_t timestamp){
+	if(settle_time == 0) settle_time = timestamp - plug_time;
+	enter(BQ25672_SOURCE_READY, timestamp);
+
+	int limit = current_limits[source_type];
+	bool success;
+	if(_arbiter != NULL){
+		// Input detection has overwritten IINDPM, the lowest request must be written again
+		_arbiter->invalidate(BQ25672_LIMIT_INPUT_CURRENT);
+		if(limit == 0) success = _arbiter->release(BQ25672_LIMIT_INPUT_CURRENT, BQ25672_LIMIT_CLIENT_SOURCE_MANAGER);
+		else success = _arbiter->request(BQ25672_LIMIT_INPUT_CURRENT, BQ25672_LIMIT_CLIENT_SOURCE_MANAGER, limit);
+	}
+	else{
+		success = limit == 0 || _charger->setInputCurrentLimitRegister(limit);
+	}
+
+	if(success) return true;
+	write_errors++;
+	return false;
+}
+
+bool BQ25672SourceManager::stepDown(uint32_t timestamp){
+	// One DAC write requests the next lower voltage, faster than a new detection
+	step_down_count++;
+	voltage = voltage > 9000 ? 9000 : 5000;
+	uint8_t data = voltage == 9000 ? DPDM(DPDM_3V3, DPDM_0V6) : DPDM(DPDM_0V6, DPDM_0V);
+	dpdm_driven = true;
+
+	bool success = _charger->writeRegisters(DPDM_REGISTER, &data, 1);
+	if(!success) write_errors++;
+
+	if(voltage == 5000) return ready(timestamp) && success;
+	enter(BQ25672_SOURCE_VERIFYING, timestamp);
+	return success;
+}
+
+bool BQ25672SourceManager::writeEnables(bool force_detection){
+	// HVDCP_EN, EN_9V, EN_12V and FORCE_INDET in one read and one write
+	uint8_t data;
+	if(!_charger->readRegisters(INDET_REGISTER, &data, 1)){
+		write_errors++;
+		return false;
+	}
+
+	uint8_t new_data = data & ~(FORCE_INDET_BIT | EN_12V_BIT | EN_9V_BIT | HVDCP_EN_BIT);
+	if(max_voltage > 5000) new_data |= HVDCP_EN_BIT | EN_9V_BIT;
+	if(max_voltage >= 12000) new_data |= EN_12V_BIT;
+	if(force_detection) new_data |= FORCE_INDET_BIT;
+	if(new_data == data) return true;
+
+	if(_charger->writeRegisters(INDET_REGISTER, &new_data, 1)) return true;
+	write_errors++;
+	return false;
+}
@@ -0,0 +1,76 @@
+/*
+  FILE:    BQ25672SourceManager.h
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Input source detection and HVDCP negotiation for the BQ25672
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#ifndef BQ25672_SOURCE_MANAGER_H_
+#define BQ25672_SOURCE_MANAGER_H_
+
+#include "BQ25672.h"
+#include "BQ25672LimitArbiter.h"
+
+#define BQ25672_SOURCE_IDLE 0  // No input
+#define BQ25672_SOURCE_DETECTING 1  // BC1.2 detection and HVDCP handshake running
+#define BQ25672_SOURCE_VERIFYING 2  // HVDCP: waiting for VBUS to reach the requested voltage
+#define BQ25672_SOURCE_READY 3  // Input current limit set for the source type
+
+// Source types are the VBUS_STAT codes of getBusVoltageStatus()
+#define BQ25672_SOURCE_TYPE_COUNT 16
+#define BQ25672_SOURCE_TYPE_HVDCP 4
+
+// The charger does BC1.2 detection and, with HVDCP enabled, the handshake for
+// the highest enabled voltage itself. The manager follows it with the
+// BC1.2 done and VBUS status events, checks with the ADC that VBUS reached the
+// requested voltage and steps down with the D+/D- outputs when it does not,
+// or when the source reports poor. Then the input current limit for the
+// source type is written.
+class BQ25672SourceManager {
+public:
+	BQ25672SourceManager(BQ25672 *charger);
+
+	bool begin(int max_voltage = 12000);  // mV, 5000, 9000 or 12000; writes the HVDCP enables
+	void setCurrentLimit(uint8_t source_type, int current);  // mA, 0 keeps the limit set by the charger
+	int getCurrentLimit(uint8_t source_type);
+	void setTimeouts(uint32_t detect_timeout, uint32_t verify_time);  // ms
+	void setLimitArbiter(BQ25672LimitArbiter *arbiter);  // NULL = write the registers directly
+
+	// Call with the flags and the status snapshot they were taken from
+	bool process(BQ25672EventSet flags, const BQ25672StatusSnapshot *status);  // Returns false on a write error
+	bool update(const BQ25672AdcSnapshot *adc);  // Checks VBUS and timeouts, returns false on a write error
+
+	uint8_t getState();
+	uint8_t getSourceType();  // VBUS_STAT code, see getBusVoltageStatus()
+	int getVoltage();  // mV, negotiated voltage
+	uint32_t getSettleTime();  // ms from plug-in to ready
+	uint32_t getStepDownCount();
+	uint32_t getWriteErrorCount();
+
+private:
+	BQ25672 *_charger;
+	BQ25672LimitArbiter *_arbiter;
+	int max_voltage;
+	int16_t current_limits[BQ25672_SOURCE_TYPE_COUNT];
+	uint32_t detect_timeout;
+	uint32_t verify_time;
+
+	uint8_t state;
+	uint8_t source_type;
+	int voltage;
+	uint32_t plug_time;
+	uint32_t state_time;
+	uint32_t settle_time;
+	bool forced;
+	bool dpdm_driven;  // D+/D- set by stepDown()
+	uint32_t step_down_count;
+	uint32_t write_errors;
+
+	void enter(uint8_t new_state, uint32_t timestamp);
+	bool ready(uint32_t timestamp);
+	bool stepDown(uint32_t timestamp);
+	bool writeEnables(bool force_detection);
+};
+#endif /* BQ25672_SOURCE_MANAGER_H_ */
@@ -0,0 +1,64 @@
+/*
+  FILE:    BQ25672StatusChangeDetector.cpp
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Edge events for every changed field between two BQ25672 status snapshots
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#include "BQ25672StatusChangeDetector.h"
+
+BQ25672StatusChangeDetector::BQ25672StatusChangeDetector(BQ25672StatusChangeHandler handler, void *context):
+	_handler(handler), _context(context), has_reference(false) {
+}
+
+void BQ25672StatusChangeDetector::setHandler(BQ25672StatusChangeHandler handler, void *context){
+	_handler = handler;
+	_context = context;
+}
+
+void BQ25672StatusChangeDetector::reset(){
+	has_reference = false;
+}
+
+uint64_t BQ25672StatusChangeDetector::process(const BQ25672StatusSnapshot *snapshot){
+	if(!has_reference){
+		reference = *snapshot;
+		has_reference = true;
+		return 0;
+	}
+
+	uint64_t old_bits = BQ25672::getStatusBits(&reference);
+	uint64_t new_bits = BQ25672::getStatusBits(snapshot);
+	uint64_t changed_bits = (old_bits ^ new_bits) & BQ25672_STATUS_BITS_VALID;
+	uint64_t changed_fields = 0;
+
+	while(changed_bits){
+		// The field of a changed bit starts at the nearest field start at or below it
+		uint8_t bit = __builtin_ctzll(changed_bits);
+		uint8_t field = 63 - __builtin_clzll(BQ25672_STATUS_FIELD_STARTS & ((2ULL << bit) - 1));
+		uint8_t width = BQ25672::getStatusFieldWidth(field);
+		uint64_t field_mask = ((1ULL << width) - 1) << field;
+
+		changed_bits &= ~field_mask;
+		changed_fields |= 1ULL << field;
+
+		if(_handler != NULL){
+			uint8_t old_value = (old_bits & field_mask) >> field;
+			uint8_t new_value = (new_bits & field_mask) >> field;
+			_handler(field, old_value, new_value, snapshot->timestamp, _context);
+		}
+	}
+
+	reference = *snapshot;
+	return changed_fields;
+}
+
+bool BQ25672StatusChangeDetector::hasReference(){
+	return has_reference;
+}
+
+const BQ25672StatusSnapshot *BQ25672StatusChangeDetector::getReference(){
+	return &reference;
+}
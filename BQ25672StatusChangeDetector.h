@@ -0,0 +1,36 @@
+/*
+  FILE:    BQ25672StatusChangeDetector.h
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Edge events for every changed field between two BQ25672 status snapshots
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#ifndef BQ25672_STATUS_CHANGE_DETECTOR_H_
+#define BQ25672_STATUS_CHANGE_DETECTOR_H_
+
+#include "BQ25672.h"
+
+typedef void (*BQ25672StatusChangeHandler)(uint8_t field, uint8_t old_value, uint8_t new_value, uint32_t timestamp, void *context);
+
+class BQ25672StatusChangeDetector {
+public:
+	BQ25672StatusChangeDetector(BQ25672StatusChangeHandler handler = NULL, void *context = NULL);
+
+	void setHandler(BQ25672StatusChangeHandler handler, void *context = NULL);
+	void reset();  // The next snapshot becomes the reference without edges
+
+	// Returns the changed fields as a set of BQ25672StatusField bits
+	uint64_t process(const BQ25672StatusSnapshot *snapshot);
+
+	bool hasReference();
+	const BQ25672StatusSnapshot *getReference();
+
+private:
+	BQ25672StatusChangeHandler _handler;
+	void *_context;
+	BQ25672StatusSnapshot reference;
+	bool has_reference;
+};
+#endif /* BQ25672_STATUS_CHANGE_DETECTOR_H_ */
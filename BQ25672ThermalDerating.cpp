@@ -0,0 +1,145 @@
+/*
+  FILE:    BQ25672ThermalDerating.cpp
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: PI controller that lowers the BQ25672 charge current with temperature
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#include "BQ25672ThermalDerating.h"
+
+#define CURRENT_LSB 10  // mA, of REG03
+#define CHARGE_CURRENT_MIN 50  // mA
+#define CHARGE_CURRENT_MAX 5000  // mA
+#define MAX_DELTA_TIME 1000  // ms, longer intervals are integrated as this, so a gap does not cause a jump
+
+BQ25672ThermalDerating::BQ25672ThermalDerating(BQ25672 *charger, const BQ25672NtcConverter *ntc):
+	_charger(charger), _arbiter(NULL), _ntc(ntc), max_charge_current(CHARGE_CURRENT_MAX),
+	die_setpoint(900), battery_setpoint(450), kp(100), ki(20), write_step(50),
+	has_last(false), last_timestamp(0), integral(0), charge_current_limit(CHARGE_CURRENT_MAX), written(-1),
+	die_temperature(0), battery_temperature(0), write_count(0), write_errors(0) {
+}
+
+void BQ25672ThermalDerating::setLimitArbiter(BQ25672LimitArbiter *arbiter){
+	_arbiter = arbiter;
+}
+
+bool BQ25672ThermalDerating::begin(int new_max_charge_current){
+	setMaxChargeCurrent(new_max_charge_current);
+	has_last = false;
+	integral = 0;
+	charge_current_limit = max_charge_current;
+	written = -1;
+	return writeChargeCurrent(charge_current_limit);
+}
+
+void BQ25672ThermalDerating::setMaxChargeCurrent(int new_max_charge_current){
+	if(new_max_charge_current < CHARGE_CURRENT_MIN) new_max_charge_current = CHARGE_CURRENT_MIN;
+	if(new_max_charge_current > CHARGE_CURRENT_MAX) new_max_charge_current = CHARGE_CURRENT_MAX;
+	max_charge_current = new_max_charge_current;
+}
+
+void BQ25672ThermalDerating::setSetpoints(int new_die_setpoint, int new_battery_setpoint){
+	die_setpoint = new_die_setpoint;
+	battery_setpoint = new_battery_setpoint;
+}
+
+void BQ25672ThermalDerating::setGains(int new_kp, int new_ki){
+	kp = new_kp;
+	ki = new_ki;
+}
+
+void BQ25672ThermalDerating::setWriteStep(int new_write_step){
+	write_step = new_write_step;
+}
+
+int BQ25672ThermalDerating::update(const BQ25672AdcSnapshot *snapshot){
+	die_temperature = snapshot->die_temperature * 5;
+	int32_t error = die_temperature - die_setpoint;
+
+	if(_ntc != NULL){
+		battery_temperature = _ntc->toDeciCelsius(snapshot->ntc_code);
+		int32_t battery_error = battery_temperature - battery_setpoint;
+		if(battery_error > error) error = battery_error;
+	}
+
+	uint32_t delta_time = has_last ? snapshot->timestamp - last_timestamp : 0;
+	if(delta_time > MAX_DELTA_TIME) delta_time = MAX_DELTA_TIME;
+	has_last = true;
+	last_timestamp = snapshot->timestamp;
+
+	int32_t range = max_charge_current - CHARGE_CURRENT_MIN;
+	int32_t proportional = (int32_t) kp * error / 10;
+
+	// Anti-windup: no further integration while the output is at the minimum,
+	// and the integral never goes below zero, so cooling down unwinds it at once
+	bool saturated = proportional + integral / 1000 >= range;
+	if(!(saturated && error > 0)){
+		integral += (int32_t) ki * error * (int32_t) delta_time / 10;
+	}
+	if(integral < 0) integral = 0;
+	if(integral > range * 1000) integral = range * 1000;
+
+	int32_t derating = proportional + integral / 1000;
+	if(derating < 0) derating = 0;
+	if(derating > range) derating = range;
+
+	charge_current_limit = ((max_charge_current - derating) / CURRENT_LSB) * CURRENT_LSB;
+	if(charge_current_limit < CHARGE_CURRENT_MIN) charge_current_limit = CHARGE_CURRENT_MIN;
+
+	// Only write steps of write_step, or when the limit reaches either end
+	int change = charge_current_limit - written;
+	if(change < 0) change = -change;
+	if(change >= write_step || (change != 0 && (charge_current_limit == max_charge_current || charge_current_limit == CHARGE_CURRENT_MIN))){
+		writeChargeCurrent(charge_current_limit);
+	}
+	return charge_current_limit;
+}
+
+int BQ25672ThermalDerating::getChargeCurrentLimit(){
+	// Returns value in: mA
+	return charge_current_limit;
+}
+
+int BQ25672ThermalDerating::getDerating(){
+	// Returns value in: mA
+	return max_charge_current - charge_current_limit;
+}
+
+int BQ25672ThermalDerating::getDieTemperature(){
+	// Returns value in: 0.1 C
+	return die_temperature;
+}
+
+int BQ25672ThermalDerating::getBatteryTemperature(){
+	// Returns value in: 0.1 C
+	return battery_temperature;
+}
+
+bool BQ25672ThermalDerating::isDerating(){
+	return charge_current_limit < max_charge_current;
+}
+
+uint32_t BQ25672ThermalDerating::getWriteCount(){
+	return write_count;
+}
+
+uint32_t BQ25672ThermalDerating::getWriteErrorCount(){
+	return write_errors;
+}
+
+bool BQ25672ThermalDerating::writeChargeCurrent(int new_value){
+	bool success;
+	if(_arbiter != NULL) success = _arbiter->request(BQ25672_LIMIT_CHARGE_CURRENT, BQ25672_LIMIT_CLIENT_THERMAL_DERATING, new_value);
+	else success = _charger == NULL || _charger->setChargeCurrent(new_value);
+
+	if(!success){
+		write_errors++;
+		return false;
+	}
+
+	written = new_value;
+	write_count++;
+	return true;
+}
@@ -0,0 +1,67 @@
+/*
+  FILE:    BQ25672ThermalDerating.h
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: PI controller that lowers the BQ25672 charge current with temperature
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#ifndef BQ25672_THERMAL_DERATING_H_
+#define BQ25672_THERMAL_DERATING_H_
+
+#include "BQ25672.h"
+#include "BQ25672LimitArbiter.h"
+#include "BQ25672NtcConverter.h"
+
+// Lowers the charge current smoothly before the thermal regulation of the
+// chip (setThermalRegulationThreshold) steps in. The sensor furthest above
+// its setpoint drives one PI loop. The integral only holds derating, so it
+// cannot wind up above the maximum charge current, and it stops integrating
+// while the output is at the minimum.
+class BQ25672ThermalDerating {
+public:
+	// charger may be NULL to only calculate the limit, ntc may be NULL to only use the die temperature
+	BQ25672ThermalDerating(BQ25672 *charger, const BQ25672NtcConverter *ntc = NULL);
+
+	bool begin(int max_charge_current);  // mA
+	void setMaxChargeCurrent(int max_charge_current);  // mA
+	void setSetpoints(int die_setpoint, int battery_setpoint);  // 0.1 C
+	void setGains(int kp, int ki);  // mA/C, mA/(C*s)
+	void setWriteStep(int write_step);  // mA, smaller changes are not written
+	void setLimitArbiter(BQ25672LimitArbiter *arbiter);  // NULL = write the registers directly
+
+	int update(const BQ25672AdcSnapshot *snapshot);  // Returns the charge current limit in mA
+
+	int getChargeCurrentLimit();  // mA
+	int getDerating();  // mA below the maximum charge current
+	int getDieTemperature();  // 0.1 C, of the last snapshot
+	int getBatteryTemperature();  // 0.1 C, of the last snapshot
+	bool isDerating();
+	uint32_t getWriteCount();
+	uint32_t getWriteErrorCount();
+
+private:
+	BQ25672 *_charger;
+	BQ25672LimitArbiter *_arbiter;
+	const BQ25672NtcConverter *_ntc;
+	int max_charge_current;
+	int die_setpoint;
+	int battery_setpoint;
+	int kp;
+	int ki;
+	int write_step;
+
+	bool has_last;
+	uint32_t last_timestamp;
+	int32_t integral;  // mA * 1000
+	int charge_current_limit;
+	int written;
+	int die_temperature;
+	int battery_temperature;
+	uint32_t write_count;
+	uint32_t write_errors;
+
+	bool writeChargeCurrent(int new_value);
+};
+#endif /* BQ25672_THERMAL_DERATING_H_ */
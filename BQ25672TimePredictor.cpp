@@ -0,0 +1,136 @@
+/*
+  FILE:    BQ25672TimePredictor.cpp
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Time to full and time to empty of a battery on the BQ25672
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#include "BQ25672TimePredictor.h"
+
+#define PHASE_IDLE 0
+#define PHASE_CC 1
+#define PHASE_CV 2
+#define PHASE_DONE 3
+
+#define CHARGE_STATUS_FAST 3
+#define CHARGE_STATUS_TAPER 4
+#define CURRENT_THRESHOLD 10  // mA, smaller battery currents count as idle
+#define SOC_FULL 1000  // 0.1 %
+
+BQ25672TimePredictor::BQ25672TimePredictor(BQ25672SocEstimator *soc):
+	_soc(soc), charge_voltage(4200), charge_current(1000), termination_current(200), cv_start(800),
+	average_current_x8(0), last_phase(PHASE_IDLE), time_to_full(BQ25672_TIME_UNKNOWN), time_to_empty(BQ25672_TIME_UNKNOWN) {
+}
+
+bool BQ25672TimePredictor::begin(BQ25672 *charger){
+	int new_charge_voltage = charger->getChargeVoltage();
+	int new_charge_current = charger->getChargeCurrent();
+	int new_termination_current = charger->getTerminationCurrent();
+	if(new_charge_voltage == 0 || new_charge_current == 0) return false;
+
+	setChargeParameters(new_charge_voltage, new_charge_current, new_termination_current);
+	return true;
+}
+
+void BQ25672TimePredictor::setChargeParameters(int new_charge_voltage, int new_charge_current, int new_termination_current){
+	charge_voltage = new_charge_voltage;
+	charge_current = new_charge_current;
+	termination_current = new_termination_current > 0 ? new_termination_current : 1;
+}
+
+void BQ25672TimePredictor::setCvStart(uint16_t soc){
+	cv_start = soc < SOC_FULL ? soc : SOC_FULL;
+}
+
+void BQ25672TimePredictor::update(const BQ25672AdcSnapshot *adc, const BQ25672StatusSnapshot *status){
+	int32_t current = adc->battery_current;
+
+	// Average over about 8 snapshots, restarted when the direction changes or from idle
+	if((int64_t) current * average_current_x8 <= 0){
+		average_current_x8 = current * 8;
+	}
+	else{
+		average_current_x8 += current - average_current_x8 / 8;
+	}
+	int32_t average_current = average_current_x8 / 8;
+
+	uint8_t phase = PHASE_IDLE;
+	if(status != NULL){
+		uint8_t charge_status = BQ25672::getStatusField(status, BQ25672_STATUS_CHARGE_STATUS);
+		if(charge_status >= 1 && charge_status <= CHARGE_STATUS_FAST) phase = PHASE_CC;
+		else if(charge_status == CHARGE_STATUS_TAPER) phase = PHASE_CV;
+		else if(charge_status > CHARGE_STATUS_TAPER) phase = PHASE_DONE;
+	}
+	else if(current > CURRENT_THRESHOLD){
+		phase = adc->battery_voltage >= charge_voltage - charge_voltage / 100 ? PHASE_CV : PHASE_CC;
+	}
+
+	if(last_phase == PHASE_CC && phase == PHASE_CV){
+		cv_start = (3 * (uint32_t) cv_start + _soc->getSoc()) / 4;
+	}
+	last_phase = phase;
+
+	int32_t capacity = _soc->getCapacity();
+	int32_t remaining = _soc->getRemainingCharge();
+	int32_t to_full = capacity - remaining;
+
+	if(phase == PHASE_DONE){
+		time_to_full = 0;
+	}
+	else if(phase == PHASE_CV){
+		time_to_full = cvTime(to_full, average_current);
+	}
+	else if(phase == PHASE_CC && average_current > CURRENT_THRESHOLD){
+		int32_t cv_charge = (int64_t) capacity * (SOC_FULL - cv_start) / SOC_FULL;
+		int32_t cc_charge = to_full - cv_charge;
+		if(cc_charge < 0){
+			cc_charge = 0;
+			cv_charge = to_full;
+		}
+
+		// The CV phase starts at the current of the CC phase, limited input power included
+		int32_t cv_current = average_current < charge_current ? average_current : charge_current;
+		time_to_full = (int64_t) cc_charge * 36 / (10 * average_current) + cvTime(cv_charge, cv_current);
+	}
+	else{
+		time_to_full = BQ25672_TIME_UNKNOWN;
+	}
+
+	if(average_current < -CURRENT_THRESHOLD){
+		time_to_empty = (int64_t) remaining * 36 / (10 * -average_current);
+	}
+	else{
+		time_to_empty = BQ25672_TIME_UNKNOWN;
+	}
+}
+
+uint32_t BQ25672TimePredictor::getTimeToFull(){
+	// Returns value in: s
+	return time_to_full;
+}
+
+uint32_t BQ25672TimePredictor::getTimeToEmpty(){
+	// Returns value in: s
+	return time_to_empty;
+}
+
+uint16_t BQ25672TimePredictor::getCvStart(){
+	// Returns value in: 0.1 %
+	return cv_start;
+}
+
+int BQ25672TimePredictor::getAverageCurrent(){
+	// Returns value in: mA
+	return average_current_x8 / 8;
+}
+
+uint32_t BQ25672TimePredictor::cvTime(int32_t charge, int32_t current){
+	// I(t) = I0 * exp(-t / tau) down to the termination current holds
+	// charge = tau * (I0 - Iterm), and takes tau * ln(I0 / Iterm)
+	if(current <= termination_current || charge <= 0) return 0;
+
+	float tau = charge * 3.6f / (current - termination_current);  // s
+	return tau * log((float) current / termination_current);
+}
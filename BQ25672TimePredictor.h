@@ -0,0 +1,53 @@
+/*
+  FILE:    BQ25672TimePredictor.h
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Time to full and time to empty of a battery on the BQ25672
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#ifndef BQ25672_TIME_PREDICTOR_H_
+#define BQ25672_TIME_PREDICTOR_H_
+
+#include "BQ25672.h"
+#include "BQ25672SocEstimator.h"
+
+#define BQ25672_TIME_UNKNOWN 0xFFFFFFFFUL
+
+// Time to full models the CC phase as the charge up to the CV start at the
+// measured current, and the CV phase as an exponential decay of the current
+// down to the termination current. The state of charge where CV starts is
+// learned at every CC to CV transition. Time to empty divides the remaining
+// charge by the averaged discharge current.
+class BQ25672TimePredictor {
+public:
+	BQ25672TimePredictor(BQ25672SocEstimator *soc);
+
+	bool begin(BQ25672 *charger);  // Reads the charge voltage, charge current and termination current once
+	void setChargeParameters(int charge_voltage, int charge_current, int termination_current);  // mV, mA, mA
+	void setCvStart(uint16_t soc);  // 0.1 %, initial guess of the state of charge where CV starts
+
+	// Call after BQ25672SocEstimator::update(), status may be NULL: then CV is detected from VBAT
+	void update(const BQ25672AdcSnapshot *adc, const BQ25672StatusSnapshot *status = NULL);
+
+	uint32_t getTimeToFull();  // s, BQ25672_TIME_UNKNOWN when not charging
+	uint32_t getTimeToEmpty();  // s, BQ25672_TIME_UNKNOWN when not discharging
+	uint16_t getCvStart();  // 0.1 %
+	int getAverageCurrent();  // mA
+
+private:
+	BQ25672SocEstimator *_soc;
+	int charge_voltage;
+	int charge_current;
+	int termination_current;
+	uint16_t cv_start;
+
+	int32_t average_current_x8;  // mA * 8
+	uint8_t last_phase;
+	uint32_t time_to_full;
+	uint32_t time_to_empty;
+
+	uint32_t cvTime(int32_t charge, int32_t current);
+};
+#endif /* BQ25672_TIME_PREDICTOR_H_ */
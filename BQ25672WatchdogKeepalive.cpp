@@ -0,0 +1,90 @@
+/*
+  FILE:    BQ25672WatchdogKeepalive.cpp
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Keeps the BQ25672 watchdog from expiring with minimal bus traffic
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#include "BQ25672WatchdogKeepalive.h"
+
+// Watchdog periods in ms of WATCHDOG[2:0]
+static const uint32_t watchdog_periods[8] = {0, 500, 1000, 2000, 20000, 40000, 80000, 160000};
+
+BQ25672WatchdogKeepalive::BQ25672WatchdogKeepalive(BQ25672 *charger):
+	_charger(charger), margin(50), control(0), resetting(false), last_reset(0),
+	reset_count(0), piggyback_count(0), write_errors(0) {
+}
+
+bool BQ25672WatchdogKeepalive::begin(){
+	uint8_t data;
+	if(!_charger->readRegisters(BQ25672_WATCHDOG_REGISTER, &data, 1)) return false;
+
+	control = data & ~BQ25672_WATCHDOG_RESET_BIT;
+	_charger->setWatchdogKeepalive(this);
+
+	// Reset right away, the time since the last reset is unknown
+	last_reset = millis() - getInterval();
+	return update();
+}
+
+void BQ25672WatchdogKeepalive::end(){
+	_charger->setWatchdogKeepalive(NULL);
+}
+
+void BQ25672WatchdogKeepalive::setMargin(uint8_t new_margin){
+	margin = new_margin < 100 ? new_margin : 99;
+}
+
+bool BQ25672WatchdogKeepalive::update(){
+	uint32_t interval = getInterval();
+	if(interval == 0 || millis() - last_reset < interval) return true;
+
+	// The charger ORs in WD_RST and reports the write back through notifyWrite()
+	resetting = true;
+	bool success = _charger->writeRegisters(BQ25672_WATCHDOG_REGISTER, &control, 1);
+	resetting = false;
+
+	if(!success){
+		write_errors++;
+		return false;
+	}
+	reset_count++;
+	return true;
+}
+
+void BQ25672WatchdogKeepalive::notifyWrite(uint8_t reg, const uint8_t *data, uint8_t byte_cnt){
+	if(reg > BQ25672_WATCHDOG_REGISTER || reg + byte_cnt <= BQ25672_WATCHDOG_REGISTER) return;
+
+	control = data[BQ25672_WATCHDOG_REGISTER - reg] & ~BQ25672_WATCHDOG_RESET_BIT;
+	last_reset = millis();
+	if(!resetting) piggyback_count++;
+}
+
+uint32_t BQ25672WatchdogKeepalive::getPeriod(){
+	// Returns value in: ms
+	return decodePeriod(control & BQ25672_WATCHDOG_TIME_MASK);
+}
+
+uint32_t BQ25672WatchdogKeepalive::getInterval(){
+	// Returns value in: ms
+	return getPeriod() / 100 * (100 - margin);
+}
+
+uint32_t BQ25672WatchdogKeepalive::getResetCount(){
+	return reset_count;
+}
+
+uint32_t BQ25672WatchdogKeepalive::getPiggybackCount(){
+	return piggyback_count;
+}
+
+uint32_t BQ25672WatchdogKeepalive::getWriteErrorCount(){
+	return write_errors;
+}
+
+uint32_t BQ25672WatchdogKeepalive::decodePeriod(uint8_t code){
+	// Returns value in: ms
+	return watchdog_periods[code & BQ25672_WATCHDOG_TIME_MASK];
+}
@@ -0,0 +1,55 @@
+/*
+  FILE:    BQ25672WatchdogKeepalive.h
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Keeps the BQ25672 watchdog from expiring with minimal bus traffic
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#ifndef BQ25672_WATCHDOG_KEEPALIVE_H_
+#define BQ25672_WATCHDOG_KEEPALIVE_H_
+
+#include "BQ25672.h"
+
+#define BQ25672_WATCHDOG_REGISTER 0x10  // REG10 Charger Control 1
+#define BQ25672_WATCHDOG_RESET_BIT 0x08  // WD_RST, self-clearing
+#define BQ25672_WATCHDOG_TIME_MASK 0x07  // WATCHDOG[2:0]
+
+// Resets the watchdog with a single write of the cached REG10 instead of a
+// read-modify-write. REG10 is read once in begin(), later writes of REG10
+// through the library keep the cache and the period up to date. While
+// attached, every write of REG10 carries WD_RST, so e.g. register image
+// bursts that cover REG10 make the next reset unnecessary.
+class BQ25672WatchdogKeepalive {
+public:
+	BQ25672WatchdogKeepalive(BQ25672 *charger);
+
+	bool begin();  // Reads REG10 and attaches to the charger
+	void end();  // Detaches from the charger
+	void setMargin(uint8_t margin);  // % of the watchdog period left when resetting, default 50
+
+	bool update();  // Call from the loop, writes only when the reset is due
+
+	// Called by the charger after every successful write
+	void notifyWrite(uint8_t reg, const uint8_t *data, uint8_t byte_cnt);
+
+	uint32_t getPeriod();  // ms, 0 = watchdog disabled
+	uint32_t getInterval();  // ms between resets
+	uint32_t getResetCount();  // Written resets
+	uint32_t getPiggybackCount();  // Resets that came with another write of REG10
+	uint32_t getWriteErrorCount();
+
+	static uint32_t decodePeriod(uint8_t code);  // code = getWatchdogTimerTime(), returns ms
+
+private:
+	BQ25672 *_charger;
+	uint8_t margin;
+	uint8_t control;  // Cached REG10 without WD_RST
+	bool resetting;
+	uint32_t last_reset;
+	uint32_t reset_count;
+	uint32_t piggyback_count;
+	uint32_t write_errors;
+};
+#endif /* BQ25672_WATCHDOG_KEEPALIVE_H_ */
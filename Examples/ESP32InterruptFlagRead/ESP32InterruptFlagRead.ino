@@ -1,16 +1,17 @@
 #include <BQ25672.h>
+#include <BQ25672EventQueue.h>
 
 #define INTERRUPT_PIN 19 // Tested on ESP32
 //#define INTERRUPT_PIN 0 // Aka GPIO/pin 2 on Arduino UNO and Arduino Mega
 
-BQ25672 charger = BQ25672(&Serial); // Print error flags to Serial when charger.readFlags() is called
-//BQ25672 charger = BQ25672(); // Do not print error flags when charger.readFlags() is called
+//BQ25672 charger = BQ25672(&Serial); // Print error flags to Serial when charger.readFlags() is called
+BQ25672 charger = BQ25672(); // Do not print error flags when charger.readFlags() is called, the queued events are printed below
 
-bool flag_detected = false;
+BQ25672EventQueue events; // Keeps every interrupt and the flags it reported in order
 unsigned long timer = 0;
 
-void ISR() { // Interrupt Service Routine function
-  flag_detected = true;
+void BQ25672_ISR_ATTR ISR() { // Interrupt Service Routine function
+  events.pushInterrupt(millis());
 }
 
 
@@ -48,8 +49,11 @@ void loop() {
     Serial.println();
   }
   
-  if(flag_detected){
-    flag_detected = false;
-    charger.readFlags();
+  events.process(&charger); // Reads the flags once for every queued interrupt
+
+  BQ25672EventRecord records[8];
+  uint8_t count = events.popEvents(records, 8);
+  for(int i = 0; i < count; i++){
+    Serial.println(String(records[i].timestamp) + "ms: " + BQ25672::getEventName(records[i].event));
   }
 }
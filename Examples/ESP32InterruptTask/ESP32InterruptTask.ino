@@ -0,0 +1,51 @@
+#include <BQ25672.h>
+#include <BQ25672EventDispatcher.h>
+#include <BQ25672InterruptTask.h>
+
+#define INTERRUPT_PIN 19 // Tested on ESP32
+
+BQ25672 charger = BQ25672();
+BQ25672EventDispatcher dispatcher;
+BQ25672InterruptTask interrupt_task(&charger); // Reads the flags in its own task, so loop() never touches the I2C bus for interrupts
+
+volatile bool power_good_changed = false;
+
+void IRAM_ATTR ISR() { // Interrupt Service Routine function
+  interrupt_task.notifyFromIsr();
+}
+
+void onPowerGood(uint8_t event, void *context) { // Called from the interrupt task
+  power_good_changed = true;
+}
+
+
+void setup() {
+  Serial.begin(115200);
+
+  bool error = charger.begin(/*SDA = */21, /*SCL = */22); // Begin I2C bus with specific pins (possible on e.g. ESP32, RPi Pico, etc.)
+
+  if(error){ // .begin returns 1 or higher if error occured
+    Serial.println("BQ25672 Not found");
+    while(1); // Do nothing if sensor cannot be found
+  }
+  delay(1000);
+  Serial.println("BQ25672 Started");
+
+  charger.setWatchdogTimerTime(0);                // Writing 0 disables watchdog timer, default it is set to 5, meaning 40s
+  charger.subscribe(BQ25672_EVENT_BIT(BQ25672_EVENT_POWER_GOOD) | BQ25672_EVENT_BIT(BQ25672_EVENT_CHARGE_STATUS)); // Only these events pull the INT pin
+
+  dispatcher.on(BQ25672_EVENT_POWER_GOOD, onPowerGood);
+  charger.setEventDispatcher(&dispatcher);
+
+  interrupt_task.begin(/*priority = */configMAX_PRIORITIES - 1, /*stack_size = */4096, /*core = */1);
+  attachInterrupt(INTERRUPT_PIN, ISR, FALLING);
+}
+
+
+void loop() {
+  if(power_good_changed){
+    power_good_changed = false;
+    Serial.println("Power good changed");
+  }
+  delay(10);
+}
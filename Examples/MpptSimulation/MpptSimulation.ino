@@ -0,0 +1,71 @@
+#include <BQ25672.h>
+#include <BQ25672Mppt.h>
+
+// Runs the software MPPT against a simulated solar panel, no charger needed.
+// The charger is assumed to draw more than the panel delivers, so the panel
+// voltage equals the VINDPM threshold.
+
+BQ25672Mppt perturb_observe(NULL, BQ25672_MPPT_PERTURB_OBSERVE);
+BQ25672Mppt incremental_conductance(NULL, BQ25672_MPPT_INCREMENTAL_CONDUCTANCE);
+
+float panelCurrent(float voltage, float irradiance) { // Returns value in: mA
+  float short_circuit_current = 2000 * irradiance;
+  float open_circuit_voltage = 21600;
+  float current = short_circuit_current * (1 - exp((voltage - open_circuit_voltage) / 1500));
+  return current > 0 ? current : 0;
+}
+
+float maximumPower(float irradiance) { // Returns value in: mW
+  float best = 0;
+  for(int voltage = 3600; voltage <= 22000; voltage += 10){
+    float power = voltage * panelCurrent(voltage, irradiance) / 1000;
+    if(power > best) best = power;
+  }
+  return best;
+}
+
+void runBenchmark(BQ25672Mppt &mppt, const char *name) {
+  const int steps = 2000;
+  float harvested = 0;
+  float available = 0;
+  int converged_at = -1;
+  unsigned long update_time = 0;
+
+  mppt.setStepSize(100);
+  mppt.begin(/*start_voltage = */12000);
+
+  for(int i = 0; i < steps; i++){
+    float irradiance = (i < steps / 2) ? 1.0 : 0.4 + 0.3 * sin(i * 0.02); // Step, then fast clouds
+
+    BQ25672AdcSnapshot snapshot = {};
+    snapshot.timestamp = i * 10; // 100 Hz loop
+    snapshot.bus_voltage = mppt.getVindpm();
+    snapshot.input_current = panelCurrent(snapshot.bus_voltage, irradiance);
+
+    unsigned long start = micros();
+    mppt.update(&snapshot);
+    update_time += micros() - start;
+
+    if(converged_at < 0 && mppt.isConverged()) converged_at = i;
+    harvested += snapshot.bus_voltage * (float)snapshot.input_current / 1000;
+    available += maximumPower(irradiance);
+  }
+
+  Serial.println(name);
+  Serial.println("  Converged after: " + String(converged_at) + " steps");
+  Serial.println("  Tracking efficiency: " + String(100 * harvested / available) + "%");
+  Serial.println("  Time per update: " + String((float)update_time / steps) + "us");
+}
+
+
+void setup() {
+  Serial.begin(115200);
+  delay(1000);
+
+  runBenchmark(perturb_observe, "Perturb and observe");
+  runBenchmark(incremental_conductance, "Incremental conductance");
+}
+
+
+void loop() {
+}
@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+"""Decodes a BQ25672EventLog dump into readable lines.
+
+Usage: decode_event_log.py <dump.bin>
+
+The dump is the output of BQ25672EventLog::read() (ring buffer mode) or the
+contents of the append region (append mode).
+"""
+
+import sys
+
+ID_CHARGE_STATUS = 0x40
+ID_SYNC = 0xFE
+ID_ERASED = 0xFF
+
+FLAG_NAMES = [
+    "Bus voltage present changed",
+    "Input 1 present changed",
+    "Input 2 present changed",
+    "Power good changed",
+    "Poor source detected",
+    "Watchdog timer passed",
+    "VINDPM-VOTG regulation signal detected",
+    "IINDPM-IOTG signal detected",
+    "BC12 detection status changed",
+    "Battery present status changed",
+    "Thermal regulation status changed",
+    "Reserved",
+    "Bus voltage status changed",
+    "Reserved",
+    "ICO status changed",
+    "Charge status changed",
+    "Top off timer expired",
+    "Pre-charge timer expired",
+    "Trickle charger timer expired",
+    "Fast charge timer expired",
+    "Entered or existed VSYSMIN regulation",
+    "ADC Conversion completed",
+    "D+/D- detection is completed",
+    "Reserved",
+    "TS across hot temperature (T5) is detected",
+    "TS across warm temperature (T3) is detected",
+    "TS across cool temperature (T2) is detected",
+    "TS across cold temperature (T1) is detected",
+    "VBAT falls below the threshold to enable the OTG mode",
+    "Reserved",
+    "Reserved",
+    "Reserved",
+    "Enter VAC1 OVP",
+    "Enter VAC2 OVP",
+    "Enter converter OCP",
+    "Enter discharged OCP",
+    "Enter IBUS OCP",
+    "Enter VBAT OVP",
+    "Enter VBUS OVP",
+    "Enter or exit IBAT regulation",
+    "Reserved",
+    "Reserved",
+    "TS shutdown signal rising threshold detected",
+    "Reserved",
+    "Stop OTG due to VBUS under-voltage",
+    "Stop OTG due to VBUS over voltage",
+    "Stop switching due to system over-voltage",
+    "Stop switching due to system short"
+]
+
+CHARGE_STATUS_NAMES = [
+    "Not charging",
+    "Trickle charge",
+    "Pre-charge",
+    "Fast charge (CC)",
+    "Taper charge (CV)",
+    "-",
+    "Top-off timer active",
+    "Charge done"
+]
+
+
+def describe(event_id):
+    if event_id < len(FLAG_NAMES):
+        return FLAG_NAMES[event_id]
+    if ID_CHARGE_STATUS <= event_id < ID_CHARGE_STATUS + 8:
+        return "Charge status: " + CHARGE_STATUS_NAMES[event_id - ID_CHARGE_STATUS]
+    return "Unknown id 0x%02X" % event_id
+
+
+def decode(data):
+    """Yields (time in ms, event id) for every record."""
+    time = 0
+    pos = 0
+    while pos < len(data):
+        event_id = data[pos]
+        pos += 1
+        if event_id == ID_ERASED:
+            return
+        if event_id == ID_SYNC:
+            if pos + 4 > len(data):
+                raise ValueError("Truncated sync record at offset %d" % (pos - 1))
+            time = int.from_bytes(data[pos:pos + 4], "little")
+            pos += 4
+            continue
+
+        delta = 0
+        shift = 0
+        while True:
+            if pos >= len(data):
+                raise ValueError("Truncated record at end of log")
+            byte = data[pos]
+            pos += 1
+            delta |= (byte & 0x7F) << shift
+            shift += 7
+            if not byte & 0x80:
+                break
+        time = (time + delta) & 0xFFFFFFFF
+        yield time, event_id
+
+
+def main():
+    if len(sys.argv) != 2:
+        print(__doc__.strip(), file=sys.stderr)
+        return 1
+
+    with open(sys.argv[1], "rb") as dump:
+        data = dump.read()
+
+    for time, event_id in decode(data):
+        print("%10d ms  %s" % (time, describe(event_id)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
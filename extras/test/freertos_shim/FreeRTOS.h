@@ -0,0 +1,37 @@
+/*
+  FILE:    FreeRTOS.h
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Minimal FreeRTOS task API on POSIX threads for the host tests
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+// Only used when the FreeRTOS kernel (POSIX port) is not available, see
+// CMakeLists.txt. Covers what BQ25672InterruptTask and the tests use.
+// Priorities are ignored, every task is a thread that starts right away.
+
+#ifndef BQ25672_FREERTOS_SHIM_H_
+#define BQ25672_FREERTOS_SHIM_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint32_t StackType_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdPASS 1
+#define pdFAIL 0
+
+#define configMAX_PRIORITIES 7
+#define configMINIMAL_STACK_SIZE 1024
+#define portMAX_DELAY 0xFFFFFFFFUL
+#define portTICK_PERIOD_MS 1
+#define portYIELD_FROM_ISR(x) ((void)(x))
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+#endif /* BQ25672_FREERTOS_SHIM_H_ */
@@ -0,0 +1,145 @@
+/*
+  FILE:    freertos_shim.cpp
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Minimal FreeRTOS task API on POSIX threads for the host tests
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+struct ShimTask {
+	pthread_t thread;
+	pthread_mutex_t mutex;
+	pthread_cond_t notified;
+	uint32_t notify_value;
+	TaskFunction_t function;
+	void *parameter;
+};
+
+struct ShimMutex {
+	pthread_mutex_t mutex;
+};
+
+static pthread_key_t current_task;
+static pthread_once_t current_task_once = PTHREAD_ONCE_INIT;
+
+static void createCurrentTaskKey(){
+	pthread_key_create(&current_task, NULL);
+}
+
+static void *taskThread(void *parameter){
+	ShimTask *task = (ShimTask *) parameter;
+	pthread_setspecific(current_task, task);
+	task->function(task->parameter);
+	return NULL;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t function, const char *name, uint32_t stack_depth, void *parameter, UBaseType_t priority, TaskHandle_t *handle){
+	(void) name;
+	(void) stack_depth;
+	(void) priority;
+	pthread_once(&current_task_once, createCurrentTaskKey);
+
+	ShimTask *task = new ShimTask();
+	pthread_mutex_init(&task->mutex, NULL);
+	pthread_cond_init(&task->notified, NULL);
+	task->notify_value = 0;
+	task->function = function;
+	task->parameter = parameter;
+	if(handle != NULL) *handle = task;
+
+	if(pthread_create(&task->thread, NULL, taskThread, task) != 0){
+		delete task;
+		if(handle != NULL) *handle = NULL;
+		return pdFAIL;
+	}
+	pthread_detach(task->thread);
+	return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t handle){
+	// The task object stays allocated, an ISR may still hold its handle
+	(void) handle;
+	pthread_exit(NULL);
+}
+
+void vTaskStartScheduler(){
+	while(true){
+		pause();
+	}
+}
+
+void vTaskDelay(TickType_t ticks){
+	usleep(ticks * portTICK_PERIOD_MS * 1000);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(){
+	pthread_once(&current_task_once, createCurrentTaskKey);
+	return (TaskHandle_t) pthread_getspecific(current_task);
+}
+
+TickType_t xTaskGetTickCount(){
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (TickType_t) (now.tv_sec * 1000 + now.tv_nsec / 1000000) / portTICK_PERIOD_MS;
+}
+
+TickType_t xTaskGetTickCountFromISR(){
+	return xTaskGetTickCount();
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t handle){
+	pthread_mutex_lock(&handle->mutex);
+	handle->notify_value++;
+	pthread_cond_signal(&handle->notified);
+	pthread_mutex_unlock(&handle->mutex);
+	return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t handle, BaseType_t *higher_priority_task_woken){
+	xTaskNotifyGive(handle);
+	if(higher_priority_task_woken != NULL) *higher_priority_task_woken = pdFALSE;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait){
+	(void) ticks_to_wait;  // Only portMAX_DELAY is used
+	ShimTask *task = xTaskGetCurrentTaskHandle();
+
+	pthread_mutex_lock(&task->mutex);
+	while(task->notify_value == 0){
+		pthread_cond_wait(&task->notified, &task->mutex);
+	}
+	uint32_t value = task->notify_value;
+	task->notify_value = clear_on_exit ? 0 : value - 1;
+	pthread_mutex_unlock(&task->mutex);
+	return value;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(){
+	ShimMutex *mutex = new ShimMutex();
+	pthread_mutex_init(&mutex->mutex, NULL);
+	return mutex;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t mutex, TickType_t ticks_to_wait){
+	(void) ticks_to_wait;
+	pthread_mutex_lock(&mutex->mutex);
+	return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t mutex){
+	pthread_mutex_unlock(&mutex->mutex);
+	return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t mutex){
+	pthread_mutex_destroy(&mutex->mutex);
+	delete mutex;
+}
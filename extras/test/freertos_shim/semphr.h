@@ -0,0 +1,22 @@
+/*
+  FILE:    semphr.h
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Minimal FreeRTOS task API on POSIX threads for the host tests
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#ifndef BQ25672_FREERTOS_SHIM_SEMPHR_H_
+#define BQ25672_FREERTOS_SHIM_SEMPHR_H_
+
+#include "FreeRTOS.h"
+
+typedef struct ShimMutex *SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex();
+BaseType_t xSemaphoreTake(SemaphoreHandle_t mutex, TickType_t ticks_to_wait);  // Always waits
+BaseType_t xSemaphoreGive(SemaphoreHandle_t mutex);
+void vSemaphoreDelete(SemaphoreHandle_t mutex);
+
+#endif /* BQ25672_FREERTOS_SHIM_SEMPHR_H_ */
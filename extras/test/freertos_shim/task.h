@@ -0,0 +1,31 @@
+/*
+  FILE:    task.h
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Minimal FreeRTOS task API on POSIX threads for the host tests
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#ifndef BQ25672_FREERTOS_SHIM_TASK_H_
+#define BQ25672_FREERTOS_SHIM_TASK_H_
+
+#include "FreeRTOS.h"
+
+typedef struct ShimTask *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *parameter);
+
+BaseType_t xTaskCreate(TaskFunction_t function, const char *name, uint32_t stack_depth, void *parameter, UBaseType_t priority, TaskHandle_t *handle);
+void vTaskDelete(TaskHandle_t handle);  // Only NULL (the calling task) is supported
+void vTaskStartScheduler();  // Does not return, end the test with exit()
+void vTaskDelay(TickType_t ticks);
+
+TaskHandle_t xTaskGetCurrentTaskHandle();
+TickType_t xTaskGetTickCount();
+TickType_t xTaskGetTickCountFromISR();
+
+BaseType_t xTaskNotifyGive(TaskHandle_t handle);
+void vTaskNotifyGiveFromISR(TaskHandle_t handle, BaseType_t *higher_priority_task_woken);
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait);
+
+#endif /* BQ25672_FREERTOS_SHIM_TASK_H_ */
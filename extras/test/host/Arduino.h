@@ -0,0 +1,47 @@
+/*
+  FILE:    Arduino.h
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Minimal Arduino API to build the BQ25672 library on a Linux host
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#ifndef BQ25672_HOST_ARDUINO_H_
+#define BQ25672_HOST_ARDUINO_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+
+inline void noInterrupts(){}
+inline void interrupts(){}
+
+class __FlashStringHelper;
+#define F(x) (reinterpret_cast<const __FlashStringHelper *>(x))
+#define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+#define pgm_read_ptr(p) (*(void * const *)(p))
+
+class HardwareSerial {
+public:
+	void print(const char *s){ printf("%s", s); }
+	void println(const char *s){ printf("%s\n", s); }
+	void print(int value){ printf("%d", value); }
+	void println(int value){ printf("%d\n", value); }
+	void println(){ printf("\n"); }
+	void print(const __FlashStringHelper *s){ printf("%s", (const char *) s); }
+	void println(const __FlashStringHelper *s){ printf("%s\n", (const char *) s); }
+};
+
+extern HardwareSerial Serial;
+
+#endif /* BQ25672_HOST_ARDUINO_H_ */
@@ -0,0 +1,55 @@
+/*
+  FILE:    Wire.h
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Simulated BQ25672 register file behind the Arduino TwoWire API
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#ifndef BQ25672_HOST_WIRE_H_
+#define BQ25672_HOST_WIRE_H_
+
+#include <Arduino.h>
+#include <pthread.h>
+
+// Like Arduino-ESP32 the bus is released between setting the register pointer
+// and requestFrom(). A transaction that starts while another thread is in
+// the middle of one is counted in interleaved, the bus lock must prevent it.
+class TwoWire {
+public:
+	TwoWire();
+
+	void begin(){}
+	void begin(int sda, int scl, uint32_t frequency = 0){ (void) sda; (void) scl; (void) frequency; }
+
+	void beginTransmission(uint8_t address);
+	size_t write(uint8_t data);
+	size_t write(const uint8_t *data, size_t count);
+	int endTransmission(bool stop = true);
+	uint8_t requestFrom(uint8_t address, uint8_t count);
+	int available();
+	int read();
+
+	uint8_t registers[256];
+	uint32_t transactions;
+	uint32_t interleaved;
+
+private:
+	pthread_mutex_t mutex;
+	pthread_t owner;
+	bool busy;
+	bool pointer_pending;
+	uint8_t pointer;
+	uint8_t written;
+	uint8_t rx[32];
+	uint8_t rx_count;
+	uint8_t rx_index;
+
+	void take();
+	void release();
+};
+
+extern TwoWire Wire;
+
+#endif /* BQ25672_HOST_WIRE_H_ */
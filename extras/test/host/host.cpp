@@ -0,0 +1,118 @@
+/*
+  FILE:    host.cpp
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Minimal Arduino API to build the BQ25672 library on a Linux host
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <time.h>
+#include <unistd.h>
+
+#define FLAG_REGISTER_FIRST 0x22  // 0x22..0x27 clear on read
+#define FLAG_REGISTER_LAST 0x27
+#define TRANSFER_TIME 20  // us per transfer, widens the window for interleaving
+
+HardwareSerial Serial;
+TwoWire Wire;
+
+static uint64_t monotonicMicros(){
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t) now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+static const uint64_t start_time = monotonicMicros();
+
+unsigned long millis(){
+	return (monotonicMicros() - start_time) / 1000;
+}
+
+unsigned long micros(){
+	return monotonicMicros() - start_time;
+}
+
+void delay(unsigned long ms){
+	usleep(ms * 1000);
+}
+
+TwoWire::TwoWire():
+	transactions(0), interleaved(0), busy(false), pointer_pending(false), pointer(0), written(0), rx_count(0), rx_index(0) {
+	memset(registers, 0, sizeof(registers));
+	pthread_mutex_init(&mutex, NULL);
+}
+
+void TwoWire::beginTransmission(uint8_t address){
+	(void) address;
+	take();
+	pointer_pending = true;
+	written = 0;
+}
+
+size_t TwoWire::write(uint8_t data){
+	if(pointer_pending){
+		pointer = data;
+		pointer_pending = false;
+	}
+	else{
+		registers[pointer++] = data;
+		written++;
+	}
+	return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t count){
+	for(size_t i = 0; i < count; i++) write(data[i]);
+	return count;
+}
+
+int TwoWire::endTransmission(bool stop){
+	(void) stop;
+	usleep(TRANSFER_TIME);
+
+	// A register pointer write is followed by requestFrom(), the bus is released in between
+	if(pointer_pending || written > 0) release();
+	return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t count){
+	(void) address;
+	usleep(TRANSFER_TIME);
+
+	if(count > sizeof(rx)) count = sizeof(rx);
+	for(int i = 0; i < count; i++){
+		rx[i] = registers[pointer];
+		if(pointer >= FLAG_REGISTER_FIRST && pointer <= FLAG_REGISTER_LAST) registers[pointer] = 0;
+		pointer++;
+	}
+	rx_count = count;
+	rx_index = 0;
+	release();
+	return count;
+}
+
+int TwoWire::available(){
+	return rx_count - rx_index;
+}
+
+int TwoWire::read(){
+	return rx_index < rx_count ? rx[rx_index++] : -1;
+}
+
+void TwoWire::take(){
+	pthread_mutex_lock(&mutex);
+	if(busy && !pthread_equal(owner, pthread_self())) interleaved++;
+	busy = true;
+	owner = pthread_self();
+	transactions++;
+	pthread_mutex_unlock(&mutex);
+}
+
+void TwoWire::release(){
+	pthread_mutex_lock(&mutex);
+	busy = false;
+	pthread_mutex_unlock(&mutex);
+}
@@ -0,0 +1,58 @@
+/*
+  FILE:    test_input_current_budget.cpp
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Host test of BQ25672InputCurrentBudget: the ramp never passes a dropped target
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#include <Arduino.h>
+#include "BQ25672InputCurrentBudget.h"
+
+#define BUDGET 3000  // mA
+#define MARGIN 100  // mA
+#define BUS_VOLTAGE 5000  // mV
+#define BATTERY_VOLTAGE 4000  // mV
+#define SYSTEM_LOAD 2000  // mA, arrives at LOAD_TIME
+#define LOAD_TIME 2000  // ms
+#define UPDATE_INTERVAL 50  // ms
+
+static void fail(const char *message, uint32_t time, int value){
+	printf("FAIL: %s at t=%u ms: %d mA\n", message, (unsigned) time, value);
+	exit(1);
+}
+
+int main(){
+	// Simulation without a charger, the charge current as written is what the battery gets
+	BQ25672InputCurrentBudget budget(NULL);
+	budget.setWriteInterval(3000);
+	budget.setSlewRate(1000);
+	budget.setMargin(MARGIN);
+	budget.begin(BUDGET, 5000);
+	uint32_t start = millis();
+
+	// What the charger can draw once the load is there, mapped from IBUS to IBAT
+	int load_target = (BUDGET - MARGIN - SYSTEM_LOAD) * BUS_VOLTAGE * BQ25672_BUDGET_EFFICIENCY / (BATTERY_VOLTAGE * 100);
+
+	for(uint32_t t = UPDATE_INTERVAL; t <= 10000; t += UPDATE_INTERVAL){
+		int system_load = t >= LOAD_TIME ? SYSTEM_LOAD : 0;
+		int charge_current = budget.getChargeCurrent();
+
+		BQ25672AdcSnapshot snapshot = {};
+		snapshot.timestamp = start + t;
+		snapshot.bus_voltage = BUS_VOLTAGE;
+		snapshot.battery_voltage = BATTERY_VOLTAGE;
+		snapshot.battery_current = charge_current;
+		snapshot.input_current = system_load + charge_current * BATTERY_VOLTAGE * 100 / (BUS_VOLTAGE * BQ25672_BUDGET_EFFICIENCY);
+		if(!budget.update(&snapshot)) fail("update failed", t, 0);
+
+		// The reduction follows the snapshot that shows the load, after that the budget must hold
+		if(t >= LOAD_TIME + UPDATE_INTERVAL && budget.getChargeCurrent() > load_target + 10){
+			fail("charge current above the budget", t, budget.getChargeCurrent());
+		}
+	}
+
+	printf("PASS: charge current %d mA, target %d mA\n", budget.getChargeCurrent(), load_target);
+	return 0;
+}
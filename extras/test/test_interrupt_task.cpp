@@ -0,0 +1,91 @@
+/*
+  FILE:    test_interrupt_task.cpp
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Host test of BQ25672InterruptTask: notify, process, bus lock and end()
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "BQ25672.h"
+#include "BQ25672EventQueue.h"
+#include "BQ25672InterruptTask.h"
+
+#define FLAG0_REGISTER 0x22
+#define RMW_TASK_LOOPS 200
+
+BQ25672 charger;
+BQ25672EventQueue queue;
+BQ25672InterruptTask interrupt_task(&charger, &queue);
+
+static volatile bool rmw_done = false;
+static volatile bool rmw_failed = false;
+
+static void fail(const char *message){
+	printf("FAIL: %s\n", message);
+	exit(1);
+}
+
+static bool waitForProcessed(uint32_t count){
+	for(int i = 0; i < 1000; i++){
+		if(interrupt_task.getProcessedCount() >= count) return true;
+		vTaskDelay(1);
+	}
+	return false;
+}
+
+static void rmwTask(void *parameter){
+	(void) parameter;
+	for(int i = 0; i < RMW_TASK_LOOPS; i++){
+		if(!charger.setChargeCurrent(i % 2 ? 1000 : 2000)) rmw_failed = true;
+	}
+	rmw_done = true;
+	vTaskDelete(NULL);
+}
+
+static void testTask(void *parameter){
+	(void) parameter;
+
+	// One interrupt: the flag is read (and cleared) and queued as an event
+	Wire.registers[FLAG0_REGISTER] = 1 << BQ25672_EVENT_POWER_GOOD;
+	interrupt_task.notifyFromIsr();
+	if(!waitForProcessed(1)) fail("interrupt not processed");
+
+	BQ25672EventRecord record;
+	if(!queue.popEvent(&record)) fail("no event queued");
+	if(record.event != BQ25672_EVENT_POWER_GOOD) fail("wrong event");
+	if(Wire.registers[FLAG0_REGISTER] != 0) fail("flags not read");
+
+	// Register read-modify-writes from another task while interrupts are handled
+	if(xTaskCreate(rmwTask, "rmw", 4096, NULL, 1, NULL) != pdPASS) fail("cannot create task");
+	while(!rmw_done){
+		Wire.registers[FLAG0_REGISTER] = 1 << BQ25672_EVENT_POWER_GOOD;
+		interrupt_task.notifyFromIsr();
+		vTaskDelay(1);
+	}
+	if(rmw_failed) fail("setChargeCurrent() failed");
+	if(Wire.interleaved != 0) fail("bus transactions interleaved");
+	if(charger.getChargeCurrent() != 1000) fail("charge current not written");
+
+	// end() waits until the task has deleted itself, later interrupts are ignored
+	interrupt_task.end();
+	if(interrupt_task.getTaskHandle() != NULL) fail("task still running");
+	uint32_t processed = interrupt_task.getProcessedCount();
+	interrupt_task.notifyFromIsr();
+	vTaskDelay(10);
+	if(interrupt_task.getProcessedCount() != processed) fail("interrupt processed after end()");
+	if(charger.setChargeCurrent(1500) == false) fail("charger unusable after end()");
+
+	printf("PASS: %u interrupts processed, %u bus transactions\n", (unsigned) processed, (unsigned) Wire.transactions);
+	exit(0);
+}
+
+int main(){
+	charger.begin();
+	if(!interrupt_task.begin(2)) fail("cannot start interrupt task");
+	if(xTaskCreate(testTask, "test", 8192, NULL, 1, NULL) != pdPASS) fail("cannot create test task");
+	vTaskStartScheduler();
+	return 1;
+}
@@ -0,0 +1,59 @@
+/*
+  FILE:    test_resistance_estimator.cpp
+  AUTHOR:  Marc Visser
+  VERSION: 0.0.1
+  PURPOSE: Host test of BQ25672ResistanceEstimator: a real change restarts the window
+  URL:     https://github.com/mardouwevisser/BQ25672
+  LICENCE: See LICENCE file
+*/
+
+#include <Arduino.h>
+#include "BQ25672ResistanceEstimator.h"
+
+#define BATTERY_VOLTAGE 3800  // mV, open circuit
+#define STEP_CURRENT 1000  // mA
+
+static uint32_t now = 0;
+static bool high = false;
+
+// Alternates between no current and the step current, every snapshot is a sample of resistance
+static bool step(BQ25672ResistanceEstimator *estimator, int resistance){
+	high = !high;
+	now += 500;
+
+	BQ25672AdcSnapshot snapshot = {};
+	snapshot.timestamp = now;
+	snapshot.battery_current = high ? STEP_CURRENT : 0;
+	snapshot.battery_voltage = BATTERY_VOLTAGE + snapshot.battery_current * resistance / 1000;
+	return estimator->process(&snapshot);
+}
+
+static void fail(const char *message, int value){
+	printf("FAIL: %s: %d mOhm\n", message, value);
+	exit(1);
+}
+
+int main(){
+	BQ25672ResistanceEstimator estimator;
+
+	// Fill the window at 50 mOhm, one sample more so the ring has wrapped
+	step(&estimator, 50);
+	for(int i = 0; i < BQ25672_RESISTANCE_SAMPLES + 1; i++) step(&estimator, 50);
+	if(estimator.getResistance() != 50) fail("wrong start value", estimator.getResistance());
+
+	// A full window of outliers in a row is taken as a real change
+	for(int i = 0; i < BQ25672_RESISTANCE_SAMPLES; i++){
+		if(step(&estimator, 200)) fail("outlier accepted", estimator.getLastSample());
+	}
+
+	// The restarted window only holds new samples
+	if(!step(&estimator, 200)) fail("sample after the restart rejected", estimator.getLastSample());
+	if(estimator.getResistance() != 200) fail("old samples in the estimate", estimator.getResistance());
+	for(int i = 0; i < 3; i++){
+		step(&estimator, 200);
+		if(estimator.getResistance() != 200) fail("old samples in the estimate", estimator.getResistance());
+	}
+
+	printf("PASS: %d mOhm\n", estimator.getResistance());
+	return 0;
+}